@@ -0,0 +1,1169 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: CompactFibonacciHeap
+    File: CompactFibonacciHeap.h
+
+    A FibonacciHeap whose nodes live in one growable array and link
+    to each other by 32 bit index instead of by pointer. A node takes
+    32 bytes with a long long priority, plus its value, which is kept
+    in separate blocks that never move. Handles are indices too, so
+    they stay valid when the array grows and can be stored or sent
+    elsewhere as plain integers.
+
+    Values that fhInlineValue accepts, such as 32 bit ids, are kept in
+    the node instead, a value of up to 4 bytes in what was padding, so
+    the whole node still takes 32 bytes. Those values move with the
+    array, a reference returned by get_value then only lasts until the
+    next insert.
+
+    Holds at most 2^32 - 1 nodes.
+
+    When T and Key are trivially copyable the whole forest can be saved
+    as a checkpoint: a header, then the node array and the values as
+    they are in memory, links and all. load reads them straight back
+    into the arrays in one pass, from a stream or from memory such as
+    a mapped file, so restoring is bound by I/O rather than by inserts.
+    A checkpoint is only read back on a machine with the same layout.
+    load checks every link, degree and flag of the nodes, walks every
+    sibling ring and the heap order of the forest before taking them,
+    so a damaged checkpoint throws instead of leading later operations
+    out of the array or around a loop. save writes the nodes field by
+    field, with their padding and the fields of freed nodes as 0.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "FibonacciHeap.h"
+
+struct fhCheckpointHeader {
+/// <summary>
+/// First bytes of a CompactFibonacciHeap checkpoint, followed by
+/// node_count nodes and then node_count values, unless the values are
+/// kept in the nodes.
+/// </summary>
+    static constexpr std::uint32_t checkpoint_magic = 0x4B434846;
+    static constexpr std::uint32_t checkpoint_version = 2;
+
+    // Checkpoint magic, which also tells the byte order apart, and the
+    // version of the layout.
+    std::uint32_t magic;
+    std::uint32_t version;
+
+    // Sizes of a node, a value and a priority, a checkpoint is only
+    // read by a heap of the same types.
+    std::uint32_t node_size;
+    std::uint32_t value_size;
+    std::uint32_t key_size;
+
+    std::uint32_t free_head;
+    std::uint32_t min_index;
+    std::uint32_t reserved;
+    std::uint64_t node_count;
+    std::uint64_t size;
+};
+
+template <typename T, typename Key = long long>
+class fhCompactHandle {
+/// <summary>
+/// Index of a Node in a CompactFibonacciHeap, returned by insert. A
+/// handle stays valid until its Node is removed from the heap, and can
+/// be rebuilt from the index it was saved as.
+/// </summary>
+/// <typeparam name="T">Generic object contained within the node</typeparam>
+/// <typeparam name="Key">Type of the node's priority</typeparam>
+private:
+    // Index of the Node this handle refers to.
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+
+public:
+    // A default constructed handle does not refer to any Node.
+    fhCompactHandle() {}
+
+    explicit fhCompactHandle(std::uint32_t index) : index(index) {}
+
+    std::uint32_t get_index() const { return index; }
+
+    explicit operator bool() const { return index != std::numeric_limits<std::uint32_t>::max(); }
+
+    bool operator==(const fhCompactHandle<T, Key> &other) const { return index == other.index; }
+
+    bool operator!=(const fhCompactHandle<T, Key> &other) const { return index != other.index; }
+};
+
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>>
+class CompactFibonacciHeap : private fhCompare<Compare> {
+/// <summary>
+/// Fibonacci Heap with index links, for collections large enough that
+/// the size of a node matters. Not safe to use from more than one
+/// thread at a time.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities, long long by default.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities, the node whose
+/// priority compares before every other is the minimum.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes and values.</typeparam>
+private:
+    // Index no Node has, stands for a missing link.
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+    // If the values live in the Nodes, there are no value blocks.
+    static constexpr bool inline_values = fhInlineValue<T>::value;
+
+    // Links, priority, degree and mark of one Node. While a Node is on
+    // the free list left holds the next free Node.
+    template <bool Inline, typename = void>
+    struct node_record {
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t child;
+        std::uint32_t parent;
+        Key priority;
+        std::uint8_t degree;
+        bool marked;
+        bool used;
+    };
+
+    // The same with storage for the value, placed last so a small value
+    // takes the padding after used.
+    template <typename Unused>
+    struct node_record<true, Unused> {
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t child;
+        std::uint32_t parent;
+        Key priority;
+        std::uint8_t degree;
+        bool marked;
+        bool used;
+        alignas(T) unsigned char value[sizeof(T)];
+    };
+
+    typedef node_record<inline_values> node;
+
+    // Storage for one value, at the same index as its Node.
+    union value_slot {
+        T value;
+
+        value_slot() {}
+        ~value_slot() {}
+    };
+
+    // Values are kept in blocks of 2^block_shift, so the values never
+    // move when the collection grows.
+    static constexpr std::uint32_t block_shift = 10;
+    static constexpr std::uint32_t block_size = 1u << block_shift;
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<node> node_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<value_slot> value_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<value_slot*> block_allocator;
+    typedef std::allocator_traits<value_allocator> value_traits;
+
+    // Allocator used for the value blocks.
+    value_allocator alloc;
+
+    // Every Node of the collection, indexed by handle.
+    std::vector<node, node_allocator> nodes;
+
+    // Blocks holding the values.
+    std::vector<value_slot*, block_allocator> blocks;
+
+    // Singly linked list of freed Nodes.
+    std::uint32_t free_head = nil;
+
+    // Index of the min node, the roots of the trees form a circular
+    // doubly linked list through it.
+    std::uint32_t min_index = nil;
+
+    // Number of elements in the collection.
+    std::size_t size = 0;
+
+    // Upper bound on the degree of any tree, the degree of a tree
+    // grows with the log of the number of nodes in it.
+    static constexpr unsigned max_degree = sizeof(std::uint32_t) * 12;
+
+public:
+    // Handle to a Node in the collection, returned by insert.
+    typedef fhCompactHandle<T, Key> handle;
+
+    /*
+    Default constructor, the CompactFibonacciHeap is initialized to an
+    empty collection.
+    */
+    CompactFibonacciHeap() : CompactFibonacciHeap(Compare(), Alloc()) {}
+
+    /*
+    Comparator constructor, the CompactFibonacciHeap is initialized to
+    an empty collection ordered by comp, whose nodes are allocated
+    with alloc.
+
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit CompactFibonacciHeap(const Compare &comp, const Alloc &alloc = Alloc())
+        : fhCompare<Compare>(comp), alloc(alloc), nodes(node_allocator(alloc)), blocks(block_allocator(alloc)) {}
+
+    /*
+    Allocator constructor, the CompactFibonacciHeap is initialized to
+    an empty collection whose nodes are allocated with alloc.
+
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit CompactFibonacciHeap(const Alloc &alloc) : CompactFibonacciHeap(Compare(), alloc) {}
+
+    /*
+    Copy constructor, the CompactFibonacciHeap is initialized to a copy
+    of every node in the parameter, handles of the parameter refer to
+    the same values in the copy.
+
+    @parameter: copy (CompactFibonacciHeap) - Fibonacci Heap being
+                                              copied.
+    */
+    CompactFibonacciHeap(const CompactFibonacciHeap<T, Key, Compare, Alloc> &copy)
+        : CompactFibonacciHeap(copy.get_compare(),
+                               std::allocator_traits<Alloc>::select_on_container_copy_construction(copy.get_allocator())) {
+        copy_from(copy);
+    }
+
+    /*
+    Move constructor, the CompactFibonacciHeap takes every node of the
+    parameter, which is left empty. Handles stay valid.
+
+    @parameter: other (CompactFibonacciHeap) - Fibonacci Heap being
+                                               moved from.
+    */
+    CompactFibonacciHeap(CompactFibonacciHeap<T, Key, Compare, Alloc> &&other)
+        : CompactFibonacciHeap(other.get_compare(), other.get_allocator()) {
+        swap(other);
+    }
+
+    ~CompactFibonacciHeap() {
+        clear();
+    }
+
+    CompactFibonacciHeap<T, Key, Compare, Alloc>& operator=(CompactFibonacciHeap<T, Key, Compare, Alloc> copy) {
+        /// <summary>
+        /// Replace the contents of this collection with a copy of, or the
+        /// nodes moved from, another collection.
+        /// </summary>
+        /// <param name="copy">Collection being copied, or moved
+        /// from.</param>
+        swap(copy);
+        return *this;
+    }
+
+    void swap(CompactFibonacciHeap<T, Key, Compare, Alloc> &other) {
+        /// <summary>
+        /// Exchange the contents of two collections, handles stay with
+        /// their nodes.
+        /// </summary>
+        /// <param name="other">Collection being exchanged with.</param>
+        std::swap(this->compare(), other.compare());
+        std::swap(alloc, other.alloc);
+        nodes.swap(other.nodes);
+        blocks.swap(other.blocks);
+        std::swap(free_head, other.free_head);
+        std::swap(min_index, other.min_index);
+        std::swap(size, other.size);
+    }
+
+    void reserve(std::size_t count) {
+        /// <summary>
+        /// Make room for count nodes, so inserting up to count nodes
+        /// requests no more memory.
+        /// </summary>
+        /// <param name="count">Number of nodes to make room for.</param>
+        if (count > nil) { throw std::length_error("CompactFibonacciHeap holds at most 2^32 - 1 nodes"); }
+
+        nodes.reserve(count);
+        while (!inline_values && blocks.size() * block_size < count) {
+            blocks.push_back(value_traits::allocate(alloc, block_size));
+        }
+    }
+
+    handle insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the collection.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return emplace(priority, value);
+    }
+
+    handle insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the collection, moving value into the
+        /// node.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return emplace(priority, std::move(value));
+    }
+
+    template <typename... Args>
+    handle emplace(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Insert a new Node into the collection, the value is constructed
+        /// in place.
+        /// </summary>
+        /// <param name="priority">Priority key value.</param>
+        /// <param name="args">Arguments the generic object contained by
+        /// the node is constructed from.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        std::uint32_t index = allocate(priority, std::forward<Args>(args)...);
+        add_root(index);
+        ++size;
+        return handle(index);
+    }
+
+    void delete_min() {
+        /// <summary>
+        /// Delete min and consolidate trees so that no two roots have the
+        /// same rank.
+        /// </summary>
+        std::uint32_t old_min = remove_min();
+        if (old_min != nil) { deallocate(old_min); }
+    }
+
+    std::pair<T, Key> extract_min() {
+        /// <summary>
+        /// Return the value and priority of the minimum node in the
+        /// collection, and remove it. Throws std::out_of_range if the
+        /// collection is empty.
+        /// </summary>
+        /// <returns>Value and priority of the minimum
+        /// node in the collection.</returns>
+        std::uint32_t old_min = remove_min();
+        if (old_min == nil) { throw std::out_of_range("extract_min called on an empty CompactFibonacciHeap"); }
+        std::pair<T, Key> rtn_val(std::move(value_at(old_min)), nodes[old_min].priority);
+        deallocate(old_min);
+        return rtn_val;
+    }
+
+    bool extract_min(T &value) {
+        /// <summary>
+        /// Move the value of the minimum node in the collection into
+        /// value, and remove the node.
+        /// </summary>
+        /// <param name="value">Object the minimum value is moved
+        /// into.</param>
+        /// <returns>True if a value was extracted; false if the
+        /// collection was empty.</returns>
+        std::uint32_t old_min = remove_min();
+        if (old_min == nil) { return false; }
+
+        value = std::move(value_at(old_min));
+        deallocate(old_min);
+        return true;
+    }
+
+    handle find_min() const {
+        /// <summary>
+        /// Return a handle to the minimum node in the collection, without
+        /// removing it.
+        /// </summary>
+        /// <returns>Handle to the minimum node; a handle referring to
+        /// no node if the collection is empty.</returns>
+        return handle(min_index);
+    }
+
+    const T& get_value(const handle &node) const {
+        /// <summary>
+        /// Returns the value contained by the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        return value_at(node.get_index());
+    }
+
+    const Key& get_priority(const handle &node) const {
+        /// <summary>
+        /// Returns the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        return nodes[node.get_index()].priority;
+    }
+
+    void decrease_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Lower the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node, should not
+        /// be greater than its current priority.</param>
+        change_priority(node, new_priority);
+    }
+
+    void increase_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Raise the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node, should not
+        /// be less than its current priority.</param>
+        change_priority(node, new_priority);
+    }
+
+    void change_priority(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Change the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        std::uint32_t curr_node = node.get_index(), parent_node, child, next_child;
+        std::uint32_t changed_node = curr_node;
+        Key old_priority = nodes[curr_node].priority;
+        bool was_min = (curr_node == min_index);
+        unsigned cuts = 0;
+
+        nodes[curr_node].priority = new_priority;
+        parent_node = nodes[curr_node].parent;
+
+        // A lowered node is cut while it is ordered before its parent.
+        if (less(new_priority, old_priority)) {
+            while (parent_node != nil && less(nodes[curr_node].priority, nodes[parent_node].priority)) {
+                cut(curr_node);
+                mark_utility(parent_node);
+
+                curr_node = parent_node;
+                parent_node = nodes[curr_node].parent;
+            }
+        }
+
+        // A raised node loses the children now ordered before it.
+        if (less(old_priority, new_priority) && nodes[curr_node].child != nil) {
+            child = nodes[curr_node].child;
+            nodes[nodes[child].left].right = nil;
+            nodes[curr_node].child = nil;
+
+            while (child != nil) {
+                next_child = nodes[child].right;
+                nodes[child].left = nodes[child].right = child;
+
+                if (less(nodes[child].priority, nodes[curr_node].priority)) {
+                    nodes[child].parent = nil;
+                    nodes[child].marked = false;
+                    add_root(child);
+                    ++cuts;
+                }
+                else if (nodes[curr_node].child != nil) {
+                    splice(nodes[curr_node].child, child);
+                }
+                else {
+                    nodes[curr_node].child = child;
+                }
+
+                child = next_child;
+            }
+
+            nodes[curr_node].degree = static_cast<std::uint8_t>(nodes[curr_node].degree - cuts);
+            for (unsigned i = 0; i < cuts; ++i) {
+                mark_utility(curr_node);
+            }
+        }
+
+        // Only the changed node can become the new minimum, unless the
+        // minimum itself was raised, then every root has to be checked.
+        if (was_min && less(old_priority, new_priority)) {
+            set_min();
+        }
+        else if (less(nodes[changed_node].priority, nodes[min_index].priority)) {
+            min_index = changed_node;
+        }
+    }
+
+    void erase(const handle &node) {
+        /// <summary>
+        /// Remove the node referred to by a handle from the collection. The
+        /// handle is no longer valid after this call.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        if (!node) { return; }
+
+        std::uint32_t curr_node = node.get_index();
+        std::uint32_t parent_node = nodes[curr_node].parent;
+
+        if (parent_node != nil) {
+            cut(curr_node);
+            mark_utility(parent_node);
+        }
+
+        min_index = curr_node;
+        delete_min();
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node from the collection, and give the memory
+        /// held by the collection back to its allocator.
+        /// </summary>
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+                if (nodes[i].used) { value_at(i).~T(); }
+            }
+        }
+        std::vector<node, node_allocator>(nodes.get_allocator()).swap(nodes);
+
+        for (value_slot *block : blocks) {
+            value_traits::deallocate(alloc, block, block_size);
+        }
+        blocks.clear();
+
+        free_head = min_index = nil;
+        size = 0;
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the collection.
+        /// </summary>
+        return size;
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false.
+        /// </summary>
+        return min_index == nil;
+    }
+
+    void save(std::ostream &out) const {
+        /// <summary>
+        /// Write the collection to out as a checkpoint, T and Key must be
+        /// trivially copyable. Handles refer to the same values in a
+        /// collection loaded from it.
+        /// </summary>
+        /// <param name="out">Binary stream the checkpoint is written to.</param>
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_copyable<Key>::value,
+                      "CompactFibonacciHeap checkpoints need trivially copyable values and priorities");
+
+        fhCheckpointHeader header = get_checkpoint_header();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (nodes.empty()) { return; }
+
+        // Nodes are written a block at a time, field by field over zeroed
+        // records so the padding between the fields is written as 0. A
+        // freed node only keeps its link to the next free node.
+        std::vector<char> records(std::min<std::size_t>(block_size, nodes.size()) * sizeof(node));
+        for (std::size_t first = 0; first < nodes.size(); first += block_size) {
+            std::size_t count = std::min<std::size_t>(block_size, nodes.size() - first);
+            std::memset(records.data(), 0, count * sizeof(node));
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const node &curr = nodes[first + i];
+                char *record = &records[i * sizeof(node)];
+                std::memcpy(record + offsetof(node, left), &curr.left, sizeof(curr.left));
+                if (!curr.used) { continue; }
+
+                std::memcpy(record + offsetof(node, right), &curr.right, sizeof(curr.right));
+                std::memcpy(record + offsetof(node, child), &curr.child, sizeof(curr.child));
+                std::memcpy(record + offsetof(node, parent), &curr.parent, sizeof(curr.parent));
+                std::memcpy(record + offsetof(node, priority), &curr.priority, sizeof(curr.priority));
+                std::memcpy(record + offsetof(node, degree), &curr.degree, sizeof(curr.degree));
+                std::memcpy(record + offsetof(node, marked), &curr.marked, sizeof(curr.marked));
+                std::memcpy(record + offsetof(node, used), &curr.used, sizeof(curr.used));
+                if constexpr (inline_values) {
+                    std::memcpy(record + offsetof(node, value), curr.value, sizeof(curr.value));
+                }
+            }
+            out.write(records.data(), static_cast<std::streamsize>(count * sizeof(node)));
+        }
+        if (inline_values) { return; }
+
+        // Values are written a block at a time, with the slots of freed
+        // nodes zeroed instead of whatever they last held.
+        std::vector<char> staging(block_size * sizeof(T));
+        for (std::size_t first = 0; first < nodes.size(); first += block_size) {
+            std::size_t count = std::min<std::size_t>(block_size, nodes.size() - first);
+            std::memcpy(staging.data(), blocks[first >> block_shift], count * sizeof(T));
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!nodes[first + i].used) { std::memset(&staging[i * sizeof(T)], 0, sizeof(T)); }
+            }
+            out.write(staging.data(), static_cast<std::streamsize>(count * sizeof(T)));
+        }
+    }
+
+    std::size_t get_checkpoint_size() const {
+        /// <summary>
+        /// Returns the number of bytes save writes.
+        /// </summary>
+        return sizeof(fhCheckpointHeader) + nodes.size() * (sizeof(node) + (inline_values ? 0 : sizeof(T)));
+    }
+
+    void load(std::istream &in) {
+        /// <summary>
+        /// Replace the contents of this collection with a checkpoint
+        /// written by save. Nothing changes if the checkpoint can't be
+        /// read.
+        /// </summary>
+        /// <param name="in">Binary stream the checkpoint is read from.</param>
+        load_checkpoint([&in](void *bytes, std::size_t count) {
+            in.read(static_cast<char*>(bytes), static_cast<std::streamsize>(count));
+            return static_cast<std::size_t>(in.gcount()) == count;
+        });
+    }
+
+    void load(const void *data, std::size_t bytes) {
+        /// <summary>
+        /// Replace the contents of this collection with a checkpoint
+        /// held in memory, such as a mapped checkpoint file. Nothing
+        /// changes if the checkpoint can't be read.
+        /// </summary>
+        /// <param name="data">First byte of the checkpoint.</param>
+        /// <param name="bytes">Number of bytes at data.</param>
+        const char *next = static_cast<const char*>(data);
+        load_checkpoint([&next, &bytes](void *out, std::size_t count) {
+            if (count == 0) { return true; }
+            if (count > bytes) { return false; }
+
+            std::memcpy(out, next, count);
+            next += count;
+            bytes -= count;
+            return true;
+        });
+    }
+
+    Compare get_compare() const {
+        /// <summary>
+        /// Returns a copy of the comparator ordering the priorities.
+        /// </summary>
+        return this->compare();
+    }
+
+    Alloc get_allocator() const {
+        /// <summary>
+        /// Returns a copy of the allocator used for the nodes.
+        /// </summary>
+        return Alloc(alloc);
+    }
+
+private:
+    bool less(const Key &a, const Key &b) const {
+        /// <summary>
+        /// Returns true if priority a is ordered before priority b.
+        /// </summary>
+        return this->compare()(a, b);
+    }
+
+    T& value_at(std::uint32_t index) {
+        /// <summary>
+        /// Returns the value of the Node at index.
+        /// </summary>
+        if constexpr (inline_values) {
+            return *std::launder(reinterpret_cast<T*>(nodes[index].value));
+        }
+        else {
+            return blocks[index >> block_shift][index & (block_size - 1)].value;
+        }
+    }
+
+    const T& value_at(std::uint32_t index) const {
+        /// <summary>
+        /// Returns the value of the Node at index.
+        /// </summary>
+        if constexpr (inline_values) {
+            return *std::launder(reinterpret_cast<const T*>(nodes[index].value));
+        }
+        else {
+            return blocks[index >> block_shift][index & (block_size - 1)].value;
+        }
+    }
+
+    template <typename... Args>
+    std::uint32_t allocate(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Construct a Node, reusing a freed one when there is one.
+        /// </summary>
+        /// <param name="priority">Priority of the Node.</param>
+        /// <param name="args">Arguments the Node's value is constructed
+        /// from.</param>
+        /// <returns>Index of the new Node.</returns>
+        std::uint32_t index;
+
+        if constexpr (inline_values) {
+            // The value is built before the Node array can grow, so args
+            // may refer to values held in the Nodes.
+            T value(std::forward<Args>(args)...);
+            index = take_slot();
+            ::new (static_cast<void*>(nodes[index].value)) T(value);
+        }
+        else {
+            // Values live in blocks that never move, so the Node is only
+            // taken once its value is built, and a throwing constructor
+            // leaves the free list and the Node array as they were.
+            index = free_head != nil ? free_head : next_index();
+            ::new (static_cast<void*>(&value_at(index))) T(std::forward<Args>(args)...);
+            try {
+                take_slot();
+            }
+            catch (...) {
+                value_at(index).~T();
+                throw;
+            }
+        }
+
+        // Set field by field, an inline value is already in the Node.
+        node &curr = nodes[index];
+        curr.left = curr.right = index;
+        curr.child = curr.parent = nil;
+        curr.priority = priority;
+        curr.degree = 0;
+        curr.marked = false;
+        curr.used = true;
+        return index;
+    }
+
+    std::uint32_t next_index() {
+        /// <summary>
+        /// Returns the index a new Node would be added at, making sure
+        /// there is a value block for it.
+        /// </summary>
+        if (nodes.size() >= nil) { throw std::length_error("CompactFibonacciHeap holds at most 2^32 - 1 nodes"); }
+
+        std::uint32_t index = static_cast<std::uint32_t>(nodes.size());
+        if (!inline_values && (index >> block_shift) == blocks.size()) {
+            blocks.push_back(value_traits::allocate(alloc, block_size));
+        }
+        return index;
+    }
+
+    std::uint32_t take_slot() {
+        /// <summary>
+        /// Take a Node off the free list, or add one to the end of the
+        /// array when the list is empty.
+        /// </summary>
+        /// <returns>Index of the Node taken.</returns>
+        if (free_head != nil) {
+            std::uint32_t index = free_head;
+            free_head = nodes[index].left;
+            return index;
+        }
+
+        std::uint32_t index = next_index();
+        nodes.push_back(node());
+        return index;
+    }
+
+    void deallocate(std::uint32_t index) {
+        /// <summary>
+        /// Destroy the value of a Node, and put the Node on the free list.
+        /// </summary>
+        /// <param name="index">Index of the Node.</param>
+        value_at(index).~T();
+        if constexpr (inline_values) { std::memset(nodes[index].value, 0, sizeof(T)); }
+        nodes[index].used = false;
+        nodes[index].left = free_head;
+        free_head = index;
+    }
+
+    void splice(std::uint32_t a, std::uint32_t b) {
+        /// <summary>
+        /// Concatenate the circular list containing b into the circular
+        /// list containing a, directly after a.
+        /// </summary>
+        std::uint32_t a_right = nodes[a].right;
+        std::uint32_t b_right = nodes[b].right;
+
+        nodes[a].right = b_right;
+        nodes[b_right].left = a;
+        nodes[b].right = a_right;
+        nodes[a_right].left = b;
+    }
+
+    void unlink(std::uint32_t index) {
+        /// <summary>
+        /// Remove a Node from the circular list it belongs to, leaving it
+        /// as a list of one.
+        /// </summary>
+        node &curr = nodes[index];
+        nodes[curr.left].right = curr.right;
+        nodes[curr.right].left = curr.left;
+        curr.left = curr.right = index;
+    }
+
+    void add_root(std::uint32_t index) {
+        /// <summary>
+        /// Meld a tree into the root list, and update min_index when
+        /// necessary.
+        /// </summary>
+        /// <param name="index">Root of the tree being melded.</param>
+        if (min_index == nil) {
+            nodes[index].left = nodes[index].right = index;
+            min_index = index;
+            return;
+        }
+
+        splice(min_index, index);
+        if (less(nodes[index].priority, nodes[min_index].priority)) {
+            min_index = index;
+        }
+    }
+
+    void link(std::uint32_t child, std::uint32_t parent) {
+        /// <summary>
+        /// Make the root child a child of the root parent.
+        /// </summary>
+        /// <param name="child">Root becoming a child.</param>
+        /// <param name="parent">Root the child is added to.</param>
+        nodes[child].parent = parent;
+        nodes[child].marked = false;
+
+        if (nodes[parent].child != nil) {
+            splice(nodes[parent].child, child);
+        }
+        else {
+            nodes[parent].child = child;
+        }
+
+        ++nodes[parent].degree;
+    }
+
+    void cut(std::uint32_t index) {
+        /// <summary>
+        /// Cut the tree rooted at index from its parent, and meld it into
+        /// the root list.
+        /// </summary>
+        /// <param name="index">Root of the tree being cut.</param>
+        std::uint32_t parent_node = nodes[index].parent;
+
+        if (nodes[parent_node].child == index) {
+            nodes[parent_node].child = (nodes[index].right != index) ? nodes[index].right : nil;
+        }
+        unlink(index);
+        --nodes[parent_node].degree;
+        nodes[index].parent = nil;
+        nodes[index].marked = false;
+        add_root(index);
+    }
+
+    void mark_utility(std::uint32_t index) {
+        /// <summary>
+        /// Mark a Node that lost a child, or cut it if it already had,
+        /// and carry on with its parent.
+        /// </summary>
+        /// <param name="index">Node that lost a child.</param>
+        while (nodes[index].parent != nil) {
+            if (!nodes[index].marked) {
+                nodes[index].marked = true;
+                return;
+            }
+
+            std::uint32_t parent_node = nodes[index].parent;
+            cut(index);
+            index = parent_node;
+        }
+    }
+
+    void set_min() {
+        /// <summary>
+        /// Set the min_index to the root with the lowest priority.
+        /// </summary>
+        if (min_index == nil) { return; }
+
+        std::uint32_t root = nodes[min_index].right;
+        while (root != min_index) {
+            if (less(nodes[root].priority, nodes[min_index].priority)) {
+                min_index = root;
+            }
+            root = nodes[root].right;
+        }
+    }
+
+    void consolidate_tree() {
+        /// <summary>
+        /// Link trees of the same degree until every root has a unique
+        /// degree, and point min_index at the root with the lowest
+        /// priority.
+        /// </summary>
+        if (min_index == nil) { return; }
+
+        // rank[degree] is only valid for degrees below top, slots are
+        // cleared as the degrees are reached.
+        std::array<std::uint32_t, max_degree> rank;
+        unsigned top = 0;
+
+        std::uint32_t curr_root = min_index, next_root;
+
+        // Break the circular root list so it can be walked while roots
+        // are removed from it.
+        nodes[nodes[min_index].left].right = nil;
+
+        while (curr_root != nil) {
+            next_root = nodes[curr_root].right;
+            nodes[curr_root].left = nodes[curr_root].right = curr_root;
+
+            while (true) {
+                unsigned degree = nodes[curr_root].degree;
+                while (top <= degree) { rank[top++] = nil; }
+
+                if (rank[degree] == nil) { break; }
+
+                std::uint32_t other = rank[degree];
+                rank[degree] = nil;
+
+                if (less(nodes[other].priority, nodes[curr_root].priority)) {
+                    std::swap(other, curr_root);
+                }
+                link(other, curr_root);
+            }
+
+            rank[nodes[curr_root].degree] = curr_root;
+            curr_root = next_root;
+        }
+
+        // Rebuild the root list from the rank, which also finds the new
+        // min_index.
+        min_index = nil;
+        for (unsigned degree = 0; degree < top; ++degree) {
+            if (rank[degree] != nil) { add_root(rank[degree]); }
+        }
+    }
+
+    std::uint32_t remove_min() {
+        /// <summary>
+        /// Remove the min node from the collection and consolidate trees
+        /// so that no two roots have the same rank.
+        /// </summary>
+        /// <returns>Index of the removed node; nil if the collection
+        /// was empty.</returns>
+        std::uint32_t old_min = min_index;
+        if (old_min == nil) { return nil; }
+
+        // Meld the children into the root list.
+        std::uint32_t first_child = nodes[old_min].child;
+        if (first_child != nil) {
+            std::uint32_t child = first_child;
+            do {
+                nodes[child].parent = nil;
+                child = nodes[child].right;
+            } while (child != first_child);
+
+            splice(old_min, first_child);
+            nodes[old_min].child = nil;
+        }
+
+        if (nodes[old_min].right == old_min) {
+            min_index = nil;
+        }
+        else {
+            min_index = nodes[old_min].right;
+            unlink(old_min);
+            consolidate_tree();
+        }
+
+        --size;
+        return old_min;
+    }
+
+    fhCheckpointHeader get_checkpoint_header() const {
+        /// <summary>
+        /// Returns the header of a checkpoint of the collection.
+        /// </summary>
+        fhCheckpointHeader header;
+        std::memset(&header, 0, sizeof(header));
+
+        header.magic = fhCheckpointHeader::checkpoint_magic;
+        header.version = fhCheckpointHeader::checkpoint_version;
+        header.node_size = sizeof(node);
+        header.value_size = sizeof(T);
+        header.key_size = sizeof(Key);
+        header.free_head = free_head;
+        header.min_index = min_index;
+        header.node_count = nodes.size();
+        header.size = size;
+        return header;
+    }
+
+    template <typename Read>
+    void load_checkpoint(Read read) {
+        /// <summary>
+        /// Load a checkpoint into a new collection and take its contents,
+        /// read(bytes, count) copies the next count bytes of the
+        /// checkpoint to bytes and returns false if there are fewer left.
+        /// </summary>
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_copyable<Key>::value,
+                      "CompactFibonacciHeap checkpoints need trivially copyable values and priorities");
+
+        fhCheckpointHeader header;
+        fhCheckpointHeader expected = get_checkpoint_header();
+        if (!read(&header, sizeof(header))) { throw std::runtime_error("CompactFibonacciHeap checkpoint is truncated"); }
+
+        if (header.magic != expected.magic || header.version != expected.version || header.node_size != expected.node_size ||
+            header.value_size != expected.value_size || header.key_size != expected.key_size) {
+            throw std::runtime_error("Not a CompactFibonacciHeap checkpoint of this type");
+        }
+        if (header.node_count >= nil || header.size > header.node_count ||
+            (header.min_index != nil && header.min_index >= header.node_count) ||
+            (header.free_head != nil && header.free_head >= header.node_count) ||
+            ((header.min_index == nil) != (header.size == 0))) {
+            throw std::runtime_error("CompactFibonacciHeap checkpoint is corrupt");
+        }
+
+        // The arrays are read over in place, nothing is linked again.
+        CompactFibonacciHeap<T, Key, Compare, Alloc> loaded(get_compare(), get_allocator());
+        std::size_t count = static_cast<std::size_t>(header.node_count);
+        loaded.reserve(count);
+        loaded.nodes.resize(count);
+
+        // The values are trivially copyable, so their destructors do
+        // nothing and a checkpoint that fails half way is simply
+        // dropped.
+        if (count && !read(loaded.nodes.data(), count * sizeof(node))) {
+            throw std::runtime_error("CompactFibonacciHeap checkpoint is truncated");
+        }
+        if (!loaded.is_consistent(header)) { throw std::runtime_error("CompactFibonacciHeap checkpoint is corrupt"); }
+
+        for (std::size_t first = 0; !inline_values && first < count; first += block_size) {
+            std::size_t block_count = std::min<std::size_t>(block_size, count - first);
+            if (!read(loaded.blocks[first >> block_shift], block_count * sizeof(T))) {
+                throw std::runtime_error("CompactFibonacciHeap checkpoint is truncated");
+            }
+        }
+
+        loaded.free_head = header.free_head;
+        loaded.min_index = header.min_index;
+        loaded.size = static_cast<std::size_t>(header.size);
+        swap(loaded);
+    }
+
+    bool is_consistent(const fhCheckpointHeader &header) const {
+        /// <summary>
+        /// Returns true if the nodes just read from a checkpoint can be
+        /// used without reading outside the array or looping: every flag
+        /// is 0 or 1, the links of used nodes lead to used nodes, every
+        /// degree is below max_degree, the free list only holds free
+        /// nodes and ends, and the used nodes form a forest in heap
+        /// order. Every sibling ring closes on the node it starts at,
+        /// has as many nodes as its parent's degree, and every used node
+        /// is on exactly one ring reached from the minimum's.
+        /// </summary>
+        /// <param name="header">Header of the checkpoint.</param>
+        std::size_t count = nodes.size();
+        std::size_t used = 0;
+
+        // The flags are read as bytes, a bool holding anything but 0 or
+        // 1 can't be trusted.
+        auto flag = [](const bool &value) {
+            unsigned char byte;
+            std::memcpy(&byte, &value, 1);
+            return byte;
+        };
+        auto live = [this, count, &flag](std::uint32_t index) { return index < count && flag(nodes[index].used) == 1; };
+
+        for (const node &curr : nodes) {
+            if (flag(curr.used) > 1 || flag(curr.marked) > 1) { return false; }
+            if (!curr.used) { continue; }
+
+            ++used;
+            if (!live(curr.left) || !live(curr.right) || curr.degree >= max_degree) { return false; }
+            if ((curr.child != nil) != (curr.degree != 0) || (curr.child != nil && !live(curr.child))) { return false; }
+            if (curr.parent != nil && !live(curr.parent)) { return false; }
+        }
+        if (used != header.size) { return false; }
+
+        if (header.min_index != nil && (!live(header.min_index) || nodes[header.min_index].parent != nil)) { return false; }
+
+        // The free list may visit each free node once.
+        std::size_t free_count = 0;
+        for (std::uint32_t index = header.free_head; index != nil; index = nodes[index].left) {
+            if (index >= count || nodes[index].used || ++free_count > count - used) { return false; }
+        }
+
+        // Walk the root ring, then the child ring of every node reached,
+        // marking each node. A node reached twice is on two rings or
+        // below itself, and a ring that doesn't close on its start runs
+        // into a marked node, so no more than count steps are taken.
+        std::vector<bool> visited(count, false);
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> rings;
+        std::size_t reached = 0;
+        if (header.min_index != nil) { rings.emplace_back(header.min_index, nil); }
+
+        while (!rings.empty()) {
+            std::uint32_t start = rings.back().first, parent = rings.back().second;
+            rings.pop_back();
+
+            std::uint32_t index = start;
+            std::size_t length = 0;
+            do {
+                const node &curr = nodes[index];
+                if (visited[index] || curr.parent != parent || nodes[curr.right].left != index) { return false; }
+                if (parent == nil ? less(curr.priority, nodes[header.min_index].priority)
+                                  : less(curr.priority, nodes[parent].priority)) {
+                    return false;
+                }
+
+                visited[index] = true;
+                ++reached;
+                ++length;
+                if (curr.child != nil) { rings.emplace_back(curr.child, index); }
+                index = curr.right;
+            } while (index != start);
+
+            if (parent != nil && length != nodes[parent].degree) { return false; }
+        }
+        return reached == used;
+    }
+
+    void copy_from(const CompactFibonacciHeap<T, Key, Compare, Alloc> &copy) {
+        /// <summary>
+        /// Copy every node of another collection, at the same indices so
+        /// its handles refer to the same values here.
+        /// </summary>
+        /// <param name="copy">Collection being copied.</param>
+        reserve(copy.nodes.size());
+
+        // The links are copied as they are, together with the values
+        // kept inline.
+        nodes = copy.nodes;
+
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            // Values in blocks are copied a block at a time, freed slots
+            // and all.
+            for (std::size_t first = 0; !inline_values && first < nodes.size(); first += block_size) {
+                std::size_t count = std::min<std::size_t>(block_size, nodes.size() - first);
+                std::memcpy(static_cast<void*>(blocks[first >> block_shift]), copy.blocks[first >> block_shift], count * sizeof(T));
+            }
+        }
+        else {
+            // Each value is copied in, Nodes are only marked used once
+            // their value is, so a throwing copy leaves nothing behind
+            // to destroy twice.
+            for (node &curr : nodes) { curr.used = false; }
+
+            for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+                if (!copy.nodes[i].used) { continue; }
+
+                ::new (static_cast<void*>(&value_at(i))) T(copy.value_at(i));
+                nodes[i].used = true;
+            }
+        }
+
+        free_head = copy.free_head;
+        min_index = copy.min_index;
+        size = copy.size;
+    }
+};
@@ -0,0 +1,300 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ConcurrentFibonacciHeap
+    File: ConcurrentFibonacciHeap.h
+
+    A FibonacciHeap many threads can insert into at once. Every
+    producer thread inserts into a FibonacciHeap of its own, so
+    producers never wait on each other, and the consumer melds those
+    buffers into the main heap in O(1) each before it extracts.
+
+    Cost summary:
+    insert                  O(1)
+    extract_min             O(log(n) + p), p producer threads
+*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "FibonacciHeap.h"
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>>
+class ConcurrentFibonacciHeap {
+/// <summary>
+/// FibonacciHeap that is safe to insert into from any number of threads
+/// while other threads extract from it. Inserts go into a buffer owned
+/// by the inserting thread, extracts meld every buffer with something
+/// in it into the main heap first, so the minimum is always exact.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes.</typeparam>
+private:
+    typedef FibonacciHeap<T, Key, Compare, Alloc> heap_type;
+
+    // Insertion buffer of one producer thread, its lock is only ever
+    // taken by that thread and by the consumer melding it.
+    struct buffer {
+        std::mutex lock;
+        heap_type heap;
+        std::atomic<bool> pending{ false };
+
+        buffer(const Compare &comp, const Alloc &alloc) : heap(comp, alloc) {}
+    };
+
+    // The main heap comes before the buffers, so it is destroyed after
+    // them, the buffers build nodes in memory the main heap lends them.
+    std::mutex heap_lock;
+    heap_type heap;
+
+    // Owned by the collection alone, the threads only keep weak
+    // references, so they can tell when a collection is gone.
+    std::mutex buffers_lock;
+    std::vector<std::shared_ptr<buffer>> buffers;
+
+    std::atomic<std::size_t> size{ 0 };
+    const std::uint64_t id = next_id();
+
+public:
+    /*
+    Default constructor, the ConcurrentFibonacciHeap is initialized to
+    an empty collection.
+    */
+    ConcurrentFibonacciHeap() = default;
+
+    /*
+    Comparator constructor, the ConcurrentFibonacciHeap is initialized
+    to an empty collection ordered by the parameter.
+
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit ConcurrentFibonacciHeap(const Compare &comp, const Alloc &alloc = Alloc()) : heap(comp, alloc) {}
+
+    ConcurrentFibonacciHeap(const ConcurrentFibonacciHeap&) = delete;
+    ConcurrentFibonacciHeap& operator=(const ConcurrentFibonacciHeap&) = delete;
+
+    void insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the calling thread's buffer.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        emplace(priority, value);
+    }
+
+    void insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the calling thread's buffer, moving
+        /// value into the node.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        emplace(priority, std::move(value));
+    }
+
+    template <typename... Args>
+    void emplace(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Insert a new Node into the calling thread's buffer, the value
+        /// is constructed in place inside the node. Nodes move between
+        /// heaps when they are melded, so no handle is returned.
+        /// </summary>
+        /// <param name="priority">Priority key value.</param>
+        /// <param name="args">Arguments the generic object contained by
+        /// the node is constructed from.</param>
+        buffer &local = local_buffer();
+
+        std::lock_guard<std::mutex> guard(local.lock);
+        local.heap.emplace(priority, std::forward<Args>(args)...);
+        local.pending.store(true, std::memory_order_release);
+
+        // Counted before the lock is released, so the node is never
+        // extracted before it is counted.
+        size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool extract_min(T &value) {
+        /// <summary>
+        /// Move the value of the minimum node out of the collection, and
+        /// remove the node. Returns false if the collection was empty.
+        /// </summary>
+        /// <param name="value">Object the minimum node's value is moved
+        /// into.</param>
+        /// <returns>True if a node was removed;
+        /// otherwise false.</returns>
+        std::lock_guard<std::mutex> guard(heap_lock);
+        meld_buffers();
+
+        if (!heap.extract_min(value)) { return false; }
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool extract_min(T &value, Key &priority) {
+        /// <summary>
+        /// Move the value and priority of the minimum node out of the
+        /// collection, and remove the node. Returns false if the
+        /// collection was empty.
+        /// </summary>
+        /// <param name="value">Object the minimum node's value is moved
+        /// into.</param>
+        /// <param name="priority">Key the minimum node's priority is
+        /// copied into.</param>
+        /// <returns>True if a node was removed;
+        /// otherwise false.</returns>
+        std::lock_guard<std::mutex> guard(heap_lock);
+        meld_buffers();
+
+        if (heap.is_empty()) { return false; }
+        std::pair<T, Key> min = heap.extract_min();
+        value = std::move(min.first);
+        priority = std::move(min.second);
+        size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool find_min(T &value, Key &priority) {
+        /// <summary>
+        /// Copy the value and priority of the minimum node, without
+        /// removing it. Returns false if the collection was empty.
+        /// </summary>
+        /// <param name="value">Object the minimum node's value is copied
+        /// into.</param>
+        /// <param name="priority">Key the minimum node's priority is
+        /// copied into.</param>
+        /// <returns>True if the collection has a minimum node;
+        /// otherwise false.</returns>
+        std::lock_guard<std::mutex> guard(heap_lock);
+        meld_buffers();
+
+        fhNode<T, Key> *min = heap.find_min();
+        if (!min) { return false; }
+        value = min->value;
+        priority = min->priority;
+        return true;
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node inserted before the call from the
+        /// collection.
+        /// </summary>
+        std::lock_guard<std::mutex> guard(heap_lock);
+        std::lock_guard<std::mutex> buffers_guard(buffers_lock);
+
+        // Every buffer is melded, and drops the free nodes the main heap
+        // lent it, since their slabs are freed below. A buffer inserted
+        // into after this builds its nodes in memory of its own.
+        for (auto &curr : buffers) {
+            std::lock_guard<std::mutex> buffer_guard(curr->lock);
+            curr->pending.store(false, std::memory_order_relaxed);
+            heap.merge(std::move(curr->heap));
+            curr->heap.clear();
+        }
+
+        size.fetch_sub(heap.get_size(), std::memory_order_relaxed);
+        heap.clear();
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the collection,
+        /// which may be out of date by the time it is read when other
+        /// threads are using the collection.
+        /// </summary>
+        return size.load(std::memory_order_relaxed);
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false. Out of date as soon as another thread inserts
+        /// or extracts.
+        /// </summary>
+        return get_size() == 0;
+    }
+
+private:
+    static std::uint64_t next_id() {
+        /// <summary>
+        /// Returns an id no other collection of this type has had.
+        /// </summary>
+        static std::atomic<std::uint64_t> last_id{ 0 };
+        return last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    buffer& local_buffer() {
+        /// <summary>
+        /// Returns the calling thread's buffer, creating it on the
+        /// thread's first insert.
+        /// </summary>
+        /// <returns>Buffer only the calling thread inserts into.</returns>
+
+        // Buffers of the calling thread by the id of their collection,
+        // ids are never reused, so a collection that has been
+        // destroyed never matches again. Its entry is dropped the next
+        // time the thread adds one, once the weak reference expired.
+        struct local_entry {
+            std::uint64_t id;
+            std::weak_ptr<buffer> owner;
+            buffer *local;
+        };
+        thread_local std::vector<local_entry> local_buffers;
+
+        for (auto &curr : local_buffers) {
+            if (curr.id == id) { return *curr.local; }
+        }
+
+        local_buffers.erase(std::remove_if(local_buffers.begin(), local_buffers.end(),
+                                           [](const local_entry &curr) { return curr.owner.expired(); }),
+                            local_buffers.end());
+
+        std::shared_ptr<buffer> local = std::make_shared<buffer>(heap.get_compare(), heap.get_allocator());
+        {
+            std::lock_guard<std::mutex> guard(buffers_lock);
+            buffers.push_back(local);
+        }
+        local_buffers.push_back(local_entry{ id, local, local.get() });
+        return *local;
+    }
+
+    void meld_buffers() {
+        /// <summary>
+        /// Meld every buffer with nodes in it into the main heap, the
+        /// caller holds heap_lock.
+        /// </summary>
+        std::lock_guard<std::mutex> guard(buffers_lock);
+
+        for (auto &curr : buffers) {
+            if (!curr->pending.load(std::memory_order_acquire)) { continue; }
+
+            std::lock_guard<std::mutex> buffer_guard(curr->lock);
+            curr->pending.store(false, std::memory_order_relaxed);
+            heap.merge(std::move(curr->heap));
+
+            // The buffer's memory now belongs to the main heap, give it
+            // the main heap's deleted nodes to insert into, so the
+            // buffers don't keep requesting memory the main heap frees.
+            heap.lend_free_nodes(curr->heap);
+        }
+    }
+};
@@ -32,9 +32,16 @@
     is_empty:          O(1)
     insert:            O(1)
     extract_min:       O(log(n))
+    extract_k:         O(k log(n))
+    extract_while:     O(k log(n))
+    erase_if:          O(n + k log(n))
+    shift_all_keys:    O(n)
     delete_min:        O(log(n))
     change_priority:   O(1)
+    decrease_key:      O(1)
+    increase_key:      O(log(n))
     delete:            O(log(n))
+    erase:             O(log(n))
     +, += [union]:     O(1)
     find_min:          O(1)
 
@@ -43,45 +50,88 @@
     ______________________________________________________________
 */
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "fhStats.h"
 
 template <typename T>
+struct fhInlineValue {
+/// <summary>
+/// True for values small and simple enough to be kept inside their Node:
+/// trivially copyable, copy constructible, and no larger or more aligned
+/// than a pointer. Such values are copied with their Node instead of
+/// being referred to, and are never destroyed.
+/// </summary>
+/// <typeparam name="T">Generic object contained within a node</typeparam>
+    static constexpr bool value = std::is_trivially_copyable<T>::value && std::is_copy_constructible<T>::value &&
+                                  sizeof(T) <= sizeof(void*) && alignof(T) <= alignof(void*);
+};
+
+
+template <typename T, typename Key = long long>
 class fhNode {
 /// <summary>
 /// Node class, each node contains a value, and priority, and is
-/// implemented in such a way to form a heap.
+/// implemented in such a way to form a heap. The fields walked while
+/// consolidating come first. Values that fhInlineValue accepts are kept
+/// in the Node, in the padding after the mark when they fit (a 4 byte
+/// value with an 8 byte priority gives a 48 byte Node), larger values
+/// are kept outside the Node, so comparing priorities never brings the
+/// value into cache.
 /// </summary>
 /// <typeparam name="T">Generic object contained within this node</typeparam>
+/// <typeparam name="Key">Type of the node's priority</typeparam>
 public:
-    // Pointer to the Nodes parent.
-    std::shared_ptr<fhNode<T>> parent = nullptr;
+    // Neighbours of this Node in the circular doubly linked list
+    // of its siblings (or of the roots). A lone Node points to 
+    // itself.
+    fhNode<T, Key> *left = this;
+    fhNode<T, Key> *right = this;
+
+    // The nodes priority.
+    Key priority;
 
-    // Collection of Nodes children.
-    std::vector<std::shared_ptr<fhNode<T>>> children;
+    // Number of children of this Node, never above the heap's
+    // max_degree.
+    std::uint8_t degree = 0;
 
     // If this node has lost any children.
     bool marked = false;
 
-    // The nodes priority.
-    long long priority;
+    // Value contained in this Node, either the value itself or a
+    // reference to it, stored by the pool next to the values of the
+    // neighbouring Nodes.
+    typename std::conditional<fhInlineValue<T>::value, T, T&>::type value;
 
-    // Value contained in this Node.
-    T value;
+    // Pointer to one of the Nodes children, the children form a
+    // circular doubly linked list.
+    fhNode<T, Key> *child = nullptr;
 
-    // Number of tree layers below this Node.
-    unsigned degree = 0;
+    // Pointer to the Nodes parent.
+    fhNode<T, Key> *parent = nullptr;
 
-    fhNode(T value, long long priority) {
+    fhNode(const Key &priority, T &value) : priority(priority), value(value) {
         /// <summary>
         /// Construct a Node with a set priority and value, initially set
         /// to be a heap of size 1.
         /// </summary>
-        /// <param name="value">generic object contained by the node</param>
         /// <param name="priority">priority key value</param>
-        this->value = value;
-        this->priority = priority;
+        /// <param name="value">already constructed generic object
+        /// contained by the node, copied into the node if it is
+        /// kept inline</param>
     }
 
     void print() {
@@ -91,302 +141,1141 @@ public:
         for (size_t i = 0; i < degree; i++) {
             std::cout << "\\____________   ";
         }
-        std::cout << "Content: " << value << " Priority: " << priority << " Degree: " << degree 
+        std::cout << "Content: " << value << " Priority: " << priority << " Degree: " << static_cast<unsigned>(degree)
                   << " Marked: " << marked << std::endl;
-        for (auto &child : children) {
-            std::cout << "\\____________[CHILD] ";
-            child->print();
+        if (child) {
+            fhNode<T, Key> *curr = child;
+            do {
+                std::cout << "\\____________[CHILD] ";
+                curr->print();
+                curr = curr->right;
+            } while (curr != child);
         }
         std::cout << std::endl;
     }
 
-    std::shared_ptr<fhNode<T>> search(const T &key, const long long &priority) {
+    template <typename Compare>
+    fhNode<T, Key>* search(const T &key, const Key &priority, const Compare &comp) {
         /// <summary>
         /// Search a Node's tree structure for a specific Node, return a 
         /// pointer to the Node if its found otherwise false.
         /// </summary>
         /// <param name="key">Value contained in the target node.</param>
         /// <param name="priority">Priority of the target node.</param>
+        /// <param name="comp">Ordering of the priorities.</param>
         /// <returns>Pointer to target node; otherwise a nullptr.</returns>
-        std::shared_ptr<fhNode<T>> node;
+        fhNode<T, Key> *node = nullptr;
+
+        // A Node without children has nothing to search.
+        if (!child) { return nullptr; }
 
         // Search the subtree for the key
-        for (auto &child : children) {
+        fhNode<T, Key> *curr = child;
+        do {
             // If the child node matches the node being searched
             // for, return that node.
-            if (child->value == key && child->priority == priority) {
-                return child;
+            if (curr->value == key && !comp(curr->priority, priority) && !comp(priority, curr->priority)) {
+                return curr;
             }
 
             // Because of the property of heaps if the priority 
             // is greater than the target priority we can skip
-            // looking through this subtree.
-            if (child->priority > priority) {
-                continue;
-            }
-
-            // If this child has children search them.
-            if (child->children.size() != 0) {
-                node = child->search(key, priority);
+            // looking through this subtree, otherwise search the
+            // child's children.
+            if (!comp(priority, curr->priority)) {
+                node = curr->search(key, priority, comp);
             }
 
             // If node is not the nullptr than the correct node
             // was found and should be returned.
-            if (node.use_count() != 0) {
+            if (node) {
                 return node;
             }
-        }
+
+            curr = curr->right;
+        } while (curr != child);
 
         // After every element has been searched and a match has
         // not been found return the nullptr.
         return nullptr;
     }
+
+    static void splice(fhNode<T, Key> *a, fhNode<T, Key> *b) {
+        /// <summary>
+        /// Concatenate the circular list containing b into the circular
+        /// list containing a, directly after a.
+        /// </summary>
+        /// <param name="a">Node in the first list.</param>
+        /// <param name="b">Node in the second list.</param>
+        fhNode<T, Key> *a_right = a->right;
+        fhNode<T, Key> *b_right = b->right;
+
+        a->right = b_right;
+        b_right->left = a;
+        b->right = a_right;
+        a_right->left = b;
+    }
+
+    void unlink() {
+        /// <summary>
+        /// Remove this Node from the circular list it belongs to, leaving
+        /// it as a list of one.
+        /// </summary>
+        left->right = right;
+        right->left = left;
+        left = this;
+        right = this;
+    }
 };
 
 
-template <typename T>
-class FibonacciHeap {
+template <typename T, typename Key = long long, typename Alloc = std::allocator<T>>
+class fhNodePool {
+/// <summary>
+/// Slab allocator for the Nodes of a FibonacciHeap. Nodes are carved out
+/// of slabs that double in size as the pool grows, and freed Nodes are
+/// kept on a free list so later inserts can reuse them without going 
+/// back to the allocator. Every slab has a parallel array holding the
+/// values, so the Nodes themselves stay small, unless the values are
+/// kept inline in the Nodes.
+/// </summary>
+/// <typeparam name="T">Generic object contained within the nodes</typeparam>
+/// <typeparam name="Key">Type of the nodes' priorities</typeparam>
+/// <typeparam name="Alloc">Allocator the slabs are requested from</typeparam>
+private:
+    union slot;
+
+    // If the values live in the Nodes, the slabs have no value arrays.
+    static constexpr bool inline_values = fhInlineValue<T>::value;
+
+    // A free slot, and the storage for the value of the Node built in
+    // it next (unused for inline values).
+    struct free_slot {
+        slot *next;
+        T *value;
+    };
+
+    // Storage for one Node, while the Node is free the storage holds
+    // the next free slot instead.
+    union slot {
+        free_slot empty;
+        fhNode<T, Key> node;
+
+        slot() {}
+        ~slot() {}
+    };
+
+    // Storage for one value, at the same index as its Node's slot.
+    union value_slot {
+        T value;
+
+        value_slot() {}
+        ~value_slot() {}
+    };
+
+    // Block of slots requested from the allocator in one call, with
+    // the values of its Nodes.
+    struct slab {
+        slot *slots;
+        value_slot *values;
+        std::size_t count;
+    };
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<slot> slot_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<value_slot> value_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<slab> slab_allocator;
+    typedef std::allocator_traits<slot_allocator> slot_traits;
+    typedef std::allocator_traits<value_allocator> value_traits;
+
+    // Allocator used for the slabs.
+    slot_allocator alloc;
+
+    // Every slab owned by the pool.
+    std::vector<slab, slab_allocator> slabs;
+
+    // Singly linked list of freed slots.
+    slot *free_head = nullptr;
+    slot *free_tail = nullptr;
+
+    // Slots of the newest slab that have never been handed out, and
+    // the value storage of the first one.
+    slot *unused = nullptr;
+    slot *unused_end = nullptr;
+    value_slot *unused_value = nullptr;
+
+    // Number of slots in the next slab.
+    std::size_t next_count = 32;
+
+public:
+    explicit fhNodePool(const Alloc &alloc = Alloc()) : alloc(alloc), slabs(slab_allocator(alloc)) {}
+
+    fhNodePool(const fhNodePool &) = delete;
+    fhNodePool& operator=(const fhNodePool &) = delete;
+
+    ~fhNodePool() {
+        release();
+    }
+
+    Alloc get_allocator() const {
+        /// <summary>
+        /// Returns the allocator the slabs are requested from.
+        /// </summary>
+        return Alloc(alloc);
+    }
+
+    template <typename... Args>
+    fhNode<T, Key>* allocate(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Construct a Node in a free slot, growing the pool when no
+        /// slot is free.
+        /// </summary>
+        /// <param name="priority">Priority of the Node.</param>
+        /// <param name="args">Arguments the Node's value is constructed
+        /// from.</param>
+        /// <returns>Pointer to the new Node.</returns>
+        if (free_head) {
+            // The value is constructed before the slot is taken off the
+            // free list, so a throwing constructor loses nothing.
+            slot *curr_slot = free_head;
+            if constexpr (inline_values) {
+                T value(std::forward<Args>(args)...);
+
+                free_head = curr_slot->empty.next;
+                if (!free_head) { free_tail = nullptr; }
+                return ::new (static_cast<void*>(&curr_slot->node)) fhNode<T, Key>(priority, value);
+            }
+            else {
+                T *value = ::new (static_cast<void*>(curr_slot->empty.value)) T(std::forward<Args>(args)...);
+
+                free_head = curr_slot->empty.next;
+                if (!free_head) { free_tail = nullptr; }
+                return ::new (static_cast<void*>(&curr_slot->node)) fhNode<T, Key>(priority, *value);
+            }
+        }
+
+        if (unused == unused_end) {
+            grow(next_count);
+            next_count *= 2;
+        }
+        return allocate_reserved(priority, std::forward<Args>(args)...);
+    }
+
+    void reserve(std::size_t count) {
+        /// <summary>
+        /// Make sure count slots that have never been handed out are 
+        /// available next to each other, requesting them from the 
+        /// allocator in a single slab if necessary.
+        /// </summary>
+        /// <param name="count">Number of slots needed.</param>
+        if (static_cast<std::size_t>(unused_end - unused) < count) {
+            grow(count);
+        }
+    }
+
+    template <typename... Args>
+    fhNode<T, Key>* allocate_reserved(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Construct a Node in the next slot set aside by reserve, Nodes
+        /// allocated this way are adjacent in memory, and so are their
+        /// values.
+        /// </summary>
+        /// <param name="priority">Priority of the Node.</param>
+        /// <param name="args">Arguments the Node's value is constructed
+        /// from.</param>
+        /// <returns>Pointer to the new Node.</returns>
+        if constexpr (inline_values) {
+            T value(std::forward<Args>(args)...);
+
+            slot *curr_slot = unused++;
+            return ::new (static_cast<void*>(&curr_slot->node)) fhNode<T, Key>(priority, value);
+        }
+        else {
+            T *value = ::new (static_cast<void*>(&unused_value->value)) T(std::forward<Args>(args)...);
+            ++unused_value;
+
+            slot *curr_slot = unused++;
+            return ::new (static_cast<void*>(&curr_slot->node)) fhNode<T, Key>(priority, *value);
+        }
+    }
+
+    void deallocate(fhNode<T, Key> *node) {
+        /// <summary>
+        /// Destroy a Node and its value, and return its slot to the free
+        /// list.
+        /// </summary>
+        /// <param name="node">Node allocated by this pool.</param>
+        slot *curr_slot = reinterpret_cast<slot*>(node);
+        if constexpr (inline_values) {
+            node->~fhNode();
+        }
+        else {
+            T *value = &node->value;
+            value->~T();
+            node->~fhNode();
+            curr_slot->empty.value = value;
+        }
+
+        curr_slot->empty.next = free_head;
+        free_head = curr_slot;
+        if (!free_tail) { free_tail = curr_slot; }
+    }
+
+    void steal(fhNodePool &other) {
+        /// <summary>
+        /// Take ownership of every slab of another pool, the other pool
+        /// is left empty. Both pools must use equal allocators.
+        /// </summary>
+        /// <param name="other">Pool whose slabs are taken.</param>
+        if (&other == this) { return; }
+
+        slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+        other.slabs.clear();
+
+        // Append the other free list, the other pool's unused slots 
+        // are only reclaimed when their slab is released.
+        if (other.free_head) {
+            if (free_tail) { free_tail->empty.next = other.free_head; }
+            else { free_head = other.free_head; }
+            free_tail = other.free_tail;
+        }
+
+        other.free_head = other.free_tail = nullptr;
+        other.unused = other.unused_end = nullptr;
+        other.unused_value = nullptr;
+        if (other.next_count > next_count) { next_count = other.next_count; }
+    }
+
+    void lend_free(fhNodePool &other) {
+        /// <summary>
+        /// Move this pool's free list to another pool, which allocates
+        /// from it before growing. The slabs stay with this pool, so it
+        /// must outlive every Node the other pool builds in them, and
+        /// both pools must use equal allocators.
+        /// </summary>
+        /// <param name="other">Pool the free slots are lent to.</param>
+        if (&other == this || !free_head) { return; }
+
+        // Prepend to the other free list, so the lent slots are
+        // handed out first.
+        free_tail->empty.next = other.free_head;
+        if (!other.free_tail) { other.free_tail = free_tail; }
+        other.free_head = free_head;
+
+        free_head = free_tail = nullptr;
+    }
+
+    void swap(fhNodePool &other) {
+        /// <summary>
+        /// Exchange the contents of two pools.
+        /// </summary>
+        /// <param name="other">Pool being exchanged with.</param>
+        std::swap(alloc, other.alloc);
+        slabs.swap(other.slabs);
+        std::swap(free_head, other.free_head);
+        std::swap(free_tail, other.free_tail);
+        std::swap(unused, other.unused);
+        std::swap(unused_end, other.unused_end);
+        std::swap(unused_value, other.unused_value);
+        std::swap(next_count, other.next_count);
+    }
+
+    void release() {
+        /// <summary>
+        /// Give every slab back to the allocator. Any Node still in use
+        /// must have been destroyed already.
+        /// </summary>
+        value_allocator value_alloc(alloc);
+        for (auto &curr_slab : slabs) {
+            slot_traits::deallocate(alloc, curr_slab.slots, curr_slab.count);
+            if (curr_slab.values) { value_traits::deallocate(value_alloc, curr_slab.values, curr_slab.count); }
+        }
+        slabs.clear();
+
+        free_head = free_tail = nullptr;
+        unused = unused_end = nullptr;
+        unused_value = nullptr;
+        next_count = 32;
+    }
+
+private:
+    void grow(std::size_t count) {
+        /// <summary>
+        /// Request a new slab from the allocator, its slots become the
+        /// unused slots.
+        /// </summary>
+        /// <param name="count">Number of slots in the slab.</param>
+        value_allocator value_alloc(alloc);
+        slot *slots = slot_traits::allocate(alloc, count);
+        value_slot *values = nullptr;
+        if constexpr (!inline_values) { values = value_traits::allocate(value_alloc, count); }
+        slabs.push_back(slab{ slots, values, count });
+
+        // Slots the previous slab never handed out go on the free 
+        // list, so they are not lost.
+        while (unused != unused_end) {
+            unused->empty.next = free_head;
+            if constexpr (!inline_values) { unused->empty.value = &(unused_value++)->value; }
+            free_head = unused;
+            if (!free_tail) { free_tail = unused; }
+            ++unused;
+        }
+
+        unused = slots;
+        unused_end = slots + count;
+        unused_value = values;
+    }
+};
+
+
+template <typename T, typename Key, typename Compare, typename Alloc>
+class FibonacciHeap;
+
+template <typename T, typename Key = long long>
+class fhHandle {
+/// <summary>
+/// Lightweight reference to a Node returned by FibonacciHeap::insert, lets
+/// the priority of that Node be changed without searching the heap. A
+/// handle stays valid until its Node is removed from the heap.
+/// </summary>
+/// <typeparam name="T">Generic object contained within the node</typeparam>
+/// <typeparam name="Key">Type of the node's priority</typeparam>
+private:
+    template <typename, typename, typename, typename> friend class FibonacciHeap;
+
+    // Node this handle refers to.
+    fhNode<T, Key> *node = nullptr;
+
+    explicit fhHandle(fhNode<T, Key> *node) : node(node) {}
+
+public:
+    // A default constructed handle does not refer to any Node.
+    fhHandle() {}
+
+    explicit operator bool() const { return node != nullptr; }
+
+    bool operator==(const fhHandle<T, Key> &other) const { return node == other.node; }
+
+    bool operator!=(const fhHandle<T, Key> &other) const { return node != other.node; }
+};
+
+
+template <typename Compare, bool = std::is_empty<Compare>::value && !std::is_final<Compare>::value>
+class fhCompare : private Compare {
+/// <summary>
+/// Holds the comparator of a FibonacciHeap. An empty comparator is kept
+/// as a base class, so it takes up no space in the heap and each 
+/// comparison can be inlined.
+/// </summary>
+/// <typeparam name="Compare">Ordering of the priorities</typeparam>
+public:
+    explicit fhCompare(const Compare &comp) : Compare(comp) {}
+
+    const Compare& compare() const { return *this; }
+
+    Compare& compare() { return *this; }
+};
+
+template <typename Compare>
+class fhCompare<Compare, false> {
+/// <summary>
+/// Holds the comparator of a FibonacciHeap, for comparators with state
+/// (or that can't be a base class) it is kept as a member.
+/// </summary>
+/// <typeparam name="Compare">Ordering of the priorities</typeparam>
+private:
+    Compare comp;
+
+public:
+    explicit fhCompare(const Compare &comp) : comp(comp) {}
+
+    const Compare& compare() const { return comp; }
+
+    Compare& compare() { return comp; }
+};
+
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>>
+class FibonacciHeap : private fhCompare<Compare>, private fhStatsRecorder {
 /// <summary>
 /// Fibonacci Heap, Similar to binomial heap, but less rigid, lazily 
 /// defers consolidation until next delete_min.
 /// </summary>
 /// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities, long long by default.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities, the node whose
+/// priority compares before every other is the minimum.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes.</typeparam>
 private:
-    // Pointer to the max_node.
-    std::shared_ptr<fhNode<T>> min_node;
+    // Pool every node in the collection is allocated from.
+    fhNodePool<T, Key, Alloc> pool;
 
-    // Collection of trees in the FibonacciHeap
-    std::vector<std::shared_ptr<fhNode<T>>> roots;
+    // Pointer to the min_node, the roots of the trees in the 
+    // FibonacciHeap form a circular doubly linked list through it.
+    fhNode<T, Key> *min_node = nullptr;
 
     // Number of elements in the collection.
     std::size_t size = 0;
 
-    // Vector of roots used to consolidate the trees, so they
-    // all have unique degrees.
-    std::vector<std::shared_ptr<fhNode<T>>> rank;
+    // Upper bound on the degree of any tree, the degree of a tree
+    // with n nodes is at most log_phi(n), and log_phi(2) < 1.5 so 
+    // 1.5 slots per bit of std::size_t is always enough.
+    static constexpr unsigned max_degree = sizeof(std::size_t) * 12;
+
+    // State of incremental consolidation, see set_consolidation_budget.
+    // The roots in rank have unique degrees and are not linked again
+    // until one of them changes, every other root is pending.
+    struct consolidation_state {
+        std::array<fhNode<T, Key>*, max_degree> rank{};
+        unsigned ranked = 0;
+
+        // Pending roots consolidated per operation, on top of the roots
+        // the operation adds.
+        std::size_t budget;
+
+        // Root the next step starts walking from, nullptr for min_node.
+        fhNode<T, Key> *cursor = nullptr;
+
+        // False once every root is known to be in rank.
+        bool pending = true;
+
+        // Roots that joined the root list or left the rank since the
+        // last step, which pays for them on top of the budget. Every
+        // operation links what it added, so the roots stay ranked and
+        // finding the minimum never scans more than max_degree roots.
+        std::size_t added = 0;
+
+        explicit consolidation_state(std::size_t budget) : budget(budget) {}
+    };
+
+    // Only allocated while consolidation is incremental.
+    std::unique_ptr<consolidation_state> incremental;
+
+    // Roots with unique degrees linked from one part of the root list,
+    // rank[degree] is only valid for degrees below top.
+    struct rank_table {
+        std::array<fhNode<T, Key>*, max_degree> rank;
+        unsigned top = 0;
+        std::uint64_t links = 0;
+    };
+
+public:
+    // Handle to a Node in the collection, returned by insert.
+    typedef fhHandle<T, Key> handle;
+
+    // Runs job(0) to job(count - 1), in parallel where it can, and
+    // returns once every one of them finished. See
+    // set_parallel_consolidation.
+    typedef std::function<void(std::size_t count, const std::function<void(std::size_t)> &job)> executor;
+
+private:
+    // Settings of parallel consolidation, see set_parallel_consolidation.
+    struct parallel_settings {
+        std::size_t threshold;
+        std::size_t tasks;
+        executor run;
+    };
+
+    // Only allocated while consolidation can run in parallel.
+    std::unique_ptr<parallel_settings> parallel;
+
+    // If the priorities can be shifted by shift_all_keys, arithmetic
+    // priorities in an order adding the same delta to two of them
+    // never changes.
+    static constexpr bool shiftable_keys = std::is_arithmetic<Key>::value &&
+        (std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::greater<Key>>::value ||
+         std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::greater<>>::value);
 
 public:
     /*
     Default constructor, the FibonacciHeap is ininitialized to an
     empty collection.
     */
-    FibonacciHeap() {}
+    FibonacciHeap() : fhCompare<Compare>(Compare()) {}
+
+    /*
+    Compare constructor, the FibonacciHeap is ininitialized to an
+    empty collection ordered by comp, whose nodes are allocated with
+    alloc.
+
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit FibonacciHeap(const Compare &comp, const Alloc &alloc = Alloc()) 
+        : fhCompare<Compare>(comp), pool(alloc) {}
+
+    /*
+    Allocator constructor, the FibonacciHeap is ininitialized to an
+    empty collection whose nodes are allocated with alloc.
+
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit FibonacciHeap(const Alloc &alloc) : fhCompare<Compare>(Compare()), pool(alloc) {}
+
+    /*
+    Range constructor, the FibonacciHeap is initialized to every
+    (value, priority) pair in [first, last), see insert_bulk.
+
+    @parameter: first (It) - Forward iterator to the first pair.
+    @parameter: last (It) - Forward iterator past the last pair.
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    template <typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    FibonacciHeap(It first, It last, const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+        : fhCompare<Compare>(comp), pool(alloc) {
+        insert_bulk(first, last);
+    }
 
     /*
-    Copy constructior, the fibonacciHeap is initialized to the
-    parameter.
+    Copy constructior, the fibonacciHeap is initialized to a copy
+    of every node in the parameter, see clone.
 
     @parameter: copy (FibonacciHeap) - Fibonacci Heap to make this 
                                        instance a copy of.
     */
-    FibonacciHeap(const FibonacciHeap<T> &copy) { 
-        min_node = copy.min_node;
-        roots = copy.roots;
-        size = copy.size;
-        rank = copy.rank;
+    FibonacciHeap(const FibonacciHeap<T, Key, Compare, Alloc> &copy)
+        : fhCompare<Compare>(copy.compare()),
+          pool(std::allocator_traits<Alloc>::select_on_container_copy_construction(copy.get_allocator())) {
+        copy_from(copy);
+    }
+
+    /*
+    Allocator extended copy constructior, the fibonacciHeap is 
+    initialized to a copy of every node in the parameter, allocated
+    with alloc.
+
+    @parameter: copy (FibonacciHeap) - Fibonacci Heap to make this 
+                                       instance a copy of.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    FibonacciHeap(const FibonacciHeap<T, Key, Compare, Alloc> &copy, const Alloc &alloc) 
+        : fhCompare<Compare>(copy.compare()), pool(alloc) {
+        copy_from(copy);
+    }
+
+    /*
+    Move constructor, the FibonacciHeap takes every node of the
+    parameter, leaving it empty. Handles to the nodes stay valid.
+
+    @parameter: other (FibonacciHeap) - Fibonacci Heap being moved
+                                        from.
+    */
+    FibonacciHeap(FibonacciHeap<T, Key, Compare, Alloc> &&other) 
+        : fhCompare<Compare>(other.compare()), pool(other.get_allocator()) {
+        swap(other);
+    }
+
+    /*
+    Destructor, frees every node in the collection.
+    */
+    ~FibonacciHeap() {
+        clear();
+    }
+
+    FibonacciHeap<T, Key, Compare, Alloc>& operator=(FibonacciHeap<T, Key, Compare, Alloc> copy) {
+        /// <summary>
+        /// Replace the contents of this collection with a copy of 
+        /// another collection.
+        /// </summary>
+        /// <param name="copy">Collection being copied, or moved
+        /// from.</param>
+        swap(copy);
+        return *this;
+    }
+
+    void swap(FibonacciHeap<T, Key, Compare, Alloc> &other) {
+        /// <summary>
+        /// Exchange the contents of two collections, handles keep
+        /// referring to the same nodes.
+        /// </summary>
+        /// <param name="other">Collection being exchanged with.</param>
+        std::swap(this->compare(), other.compare());
+        pool.swap(other.pool);
+        std::swap(min_node, other.min_node);
+        std::swap(size, other.size);
+        std::swap(incremental, other.incremental);
+        std::swap(parallel, other.parallel);
     }
 
-    void insert(const T &value, const long long &priority) {
+    handle insert(const T &value, const Key &priority) {
         /// <summary>
         /// Insert a new Node into the fibonacci heap.
         /// </summary>
         /// <param name="value">Generic object contained by the node.</param>
         /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return emplace(priority, value);
+    }
+
+    handle insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the fibonacci heap, moving value into
+        /// the node.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return emplace(priority, std::move(value));
+    }
+
+    template <typename... Args>
+    handle emplace(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Insert a new Node into the fibonacci heap, the value is 
+        /// constructed in place inside the node.
+        /// </summary>
+        /// <param name="priority">Priority key value.</param>
+        /// <param name="args">Arguments the generic object contained by
+        /// the node is constructed from.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        timer timed(*this, fhStats::op_insert);
         
         // First, allocate a node representing a singleton tree to
         // the heap.
-        std::shared_ptr<fhNode<T>> new_node(
-            new fhNode<T>(value, priority)
-        );
-
-        // Add the new_node to the collection as a singleton tree.
-        roots.push_back(new_node);
+        fhNode<T, Key> *new_node = pool.allocate(priority, std::forward<Args>(args)...);
 
-        // Update min_node pointer if necessary.
-        if (!min_node || min_node->priority > priority) {
-            min_node = new_node;
-        }
+        // Add the new_node to the collection as a singleton tree,
+        // and update the min_node pointer if necessary.
+        add_root(new_node);
 
         // Increase the size of the collection.
         ++size;
+
+        // Pay for part of the next consolidation now.
+        if (incremental) { consolidate_step(0); }
+
+        return handle(new_node);
     }
 
-    void delete_min() {
+    template <typename It>
+    void insert_bulk(It first, It last) {
         /// <summary>
-        /// Delete min and consolidate trees so that no two roots have the
-        /// same rank.
+        /// Insert every (value, priority) pair in [first, last). The nodes
+        /// are allocated together in one block and added to the root list
+        /// in a single pass, which also finds the smallest priority.
         /// </summary>
+        /// <param name="first">Forward iterator to the first pair.</param>
+        /// <param name="last">Forward iterator past the last pair.</param>
+        timer timed(*this, fhStats::op_insert_bulk);
+        std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        fhNode<T, Key> *first_node, *last_node, *block_min, *new_node;
+
+        if (count == 0) { return; }
+
+        pool.reserve(count);
+
+        // The nodes are chained left to right in the order they were
+        // given, keeping the lowest priority node seen so far.
+        first_node = last_node = block_min = pool.allocate_reserved(first->second, first->first);
+        for (++first; first != last; ++first) {
+            new_node = pool.allocate_reserved(first->second, first->first);
+            new_node->left = last_node;
+            last_node->right = new_node;
+            last_node = new_node;
+            block_min = less(new_node->priority, block_min->priority) ? new_node : block_min;
+        }
 
-        // If the collection is empty prematurely exit the function.
-        if (!min_node) { return; }
+        // Close the chain into a circular list and splice it into the
+        // root list.
+        first_node->left = last_node;
+        last_node->right = first_node;
 
-        // Meld the children into the root list
-        for (auto &child : min_node->children) {
-            child->parent = nullptr;
-            roots.push_back(child);
+        if (!min_node) {
+            min_node = block_min;
         }
-        min_node->children.clear();
+        else {
+            fhNode<T, Key>::splice(min_node, first_node);
+            if (less(block_min->priority, min_node->priority)) {
+                min_node = block_min;
+            }
+        }
+        size += count;
+
+        // The whole block is linked now, it is paid for by the pass that
+        // built it.
+        if (incremental) {
+            incremental->pending = true;
+            incremental->added += count;
+            consolidate_step(0);
+        }
+    }
 
-        // Remove min_node from the root list, erase min_node, and
-        // set a new minimum.
-        auto it = std::find(roots.begin(), roots.end(), min_node);
-        roots.erase(it);
-        --size;
-        set_min();
-    
-        // Consolidate the trees so that no two roots have the same 
-        // rank.
-        consolidate_tree();    
+    void delete_min() {
+        /// <summary>
+        /// Delete min and consolidate trees so that no two roots have the
+        /// same rank.
+        /// </summary>
+        timer timed(*this, fhStats::op_delete_min);
+        fhNode<T, Key> *old_min = remove_min();
+        if (old_min) { pool.deallocate(old_min); }
     }
     
     void consolidate_tree() {
         /// <summary>
         /// Function to consolidate the trees within the heap. After this 
-        /// function no trees will have the same(rank / degree / number of tree
-        /// layers).
+        /// function no trees will have the same(rank / degree / number of 
+        /// children), and min_node will point to the root with the lowest
+        /// priority.
         /// </summary>
 
+        // If the collection is empty there is nothing to consolidate.
+        if (!min_node) { return; }
 
-        // Current root being checked
-        size_t current_index = 0;
-
-        // Current degree of the root being checked.
-        unsigned current_degree = 0;
-
-        // For each root add its degree to the rank, and combine
-        // trees when necessary.
-        while (current_index < roots.size()) {
-            current_degree = roots[current_index]->degree;
+        // Roots used to consolidate the trees, so they all have
+        // unique degrees, and the roots walked for the statistics.
+        rank_table table;
+        std::uint64_t roots = 0;
 
-            // Rank grows dynamically based on the trees degrees.
-            if (current_degree >= rank.size()) {
-                rank_grow(current_degree);
+        if (parallel && count_roots(parallel->threshold) >= parallel->threshold) {
+            roots = consolidate_parallel(table);
+        }
+        else {
+            // Current root being checked, and the root after it.
+            fhNode<T, Key> *curr_root = min_node, *next_root;
+
+            // Break the circular root list so it can be walked while 
+            // roots are removed from it.
+            min_node->left->right = nullptr;
+
+            // For each root add it to the rank, combining trees when
+            // the rank already holds a root with the same degree.
+            while (curr_root) {
+                next_root = curr_root->right;
+                rank_root(table, curr_root);
+                ++roots;
+                curr_root = next_root;
             }
+        }
 
-            // If the rank does not have an element at the roots
-            // degree add the root to the rank.
-            if (rank[current_degree].use_count() == 0) {
-                rank[current_degree] = roots[current_index];
-                ++current_index;
-            }
-            else {
-                // This rank has an element, so combine these trees.
-                // The tree root is determined depending on which
-                // root has lower priority.
-
-                // If the tree root stored in rank has a lower 
-                // priority than the current tree root.
-                if (rank[current_degree]->priority < roots[current_index]->priority) {
-                    // Update the new trees degree.
-                    if (rank[current_degree]->degree <= roots[current_index]->degree) {
-                        rank[current_degree]->degree = roots[current_index]->degree + 1;
-                    }
+        std::array<fhNode<T, Key>*, max_degree> &rank = table.rank;
+        unsigned top = table.top;
 
-                    // Combine the trees, and remove the larger
-                    // priority tree from the vector.
-                    rank[current_degree]->children.push_back(roots[current_index]);
-                    roots[current_index]->parent = rank[current_degree];
-                    auto it = std::find(roots.begin(), roots.end(), rank[current_degree]);
-                    roots[current_index] = rank[current_degree];
-                    rank[current_degree] = nullptr;
-                    roots.erase(it);
-                    --current_index;
-                }
+        // Rebuild the root list from the rank, and find the new 
+        // min_node.
+        min_node = nullptr;
+        for (unsigned degree = 0; degree < top; ++degree) {
+            if (rank[degree]) { add_root(rank[degree]); }
+        }
 
-                // If the current tree root has a lower priority
-                // than the tree root stored in rank.
-                else {
-                    // Update the new trees degree.
-                    if(roots[current_index]->degree <= rank[current_degree]->degree){
-                        roots[current_index]->degree = rank[current_degree]->degree + 1;
-                    }
+        record_consolidation(roots, table.links, top - 1);
 
-                    // Combine the trees, and remove the larger
-                    // priority tree from the vector.
-                    roots[current_index]->children.push_back(rank[current_degree]);
-                    rank[current_degree]->parent = roots[current_index];
-                    auto it = std::find(roots.begin(), roots.end(), rank[current_degree]);
-                    roots.erase(it);
-                    rank[current_degree] = nullptr;
-                    --current_index;
+        // Every root now has a unique degree, so none is pending.
+        if (incremental) {
+            incremental->rank.fill(nullptr);
+            incremental->ranked = 0;
+            for (unsigned degree = 0; degree < top; ++degree) {
+                if (rank[degree]) {
+                    incremental->rank[degree] = rank[degree];
+                    ++incremental->ranked;
                 }
             }
+            incremental->cursor = nullptr;
+            incremental->pending = false;
+            incremental->added = 0;
         }
-
-        clear_rank();
     }
 
-    void rank_grow(unsigned degree) {
+    void set_consolidation_budget(std::size_t roots) {
         /// <summary>
-        /// Given a degree grow rank to match that degree
+        /// Consolidate incrementally, every insert and extract links
+        /// a bounded number of roots instead of the whole root list at
+        /// once, which flattens the latency of the first delete_min after
+        /// many inserts. Each operation consolidates the roots it added
+        /// plus roots more of those left pending, each of them taking at
+        /// most max_degree links, so the roots stay ranked and removing
+        /// the minimum scans at most max_degree of them for the next one.
+        /// insert_bulk and merge link the roots they add at once, in the
+        /// pass they already make. The roots present when the budget is
+        /// first set are consolidated right away. 0 goes back to
+        /// consolidating everything at once.
         /// </summary>
-        
-        // grow rank to the correct degree size
-        for (size_t i = 0; i < degree - (rank.size() - 1); ++i) {
-            rank.push_back(nullptr);
+        /// <param name="roots">Pending roots consolidated per operation,
+        /// or 0 to consolidate fully.</param>
+        if (!roots) {
+            incremental.reset();
+            return;
+        }
+
+        if (incremental) {
+            incremental->budget = roots;
+            return;
         }
+
+        incremental.reset(new consolidation_state(roots));
+        consolidate_tree();
     }
 
-    void print_heap() { 
+    std::size_t get_consolidation_budget() const {
         /// <summary>
-        /// Print the contents of this collection.
+        /// Returns the number of pending roots consolidated per
+        /// operation, 0 if the trees are consolidated all at once.
         /// </summary>
-        if (min_node) { std::cout << "min_node: " << min_node->value << std::endl; }
-        for (auto &root : roots) { root->print(); }
+        return incremental ? incremental->budget : 0;
     }
 
-    void set_min() {
+    void set_parallel_consolidation(std::size_t threshold, std::size_t tasks = 0, executor run = executor()) {
         /// <summary>
-        /// Set the min_node to the root with the lowest priority.
+        /// Consolidate root lists of at least threshold roots in
+        /// parallel, as after insert_bulk or merging many heaps. The
+        /// roots are split into tasks parts that are linked into a
+        /// degree table each, then the tables are merged pairwise in
+        /// log(tasks) rounds. Compare must be safe to call from several
+        /// threads at once.
         /// </summary>
-        min_node = nullptr;
-        for (auto &root : roots) {
-            if (!min_node || root->priority <= min_node->priority)
-                min_node = root;
+        /// <param name="threshold">Fewest roots consolidated in
+        /// parallel, 0 to always consolidate on the calling
+        /// thread.</param>
+        /// <param name="tasks">Number of parts the roots are split into,
+        /// the number of hardware threads if 0.</param>
+        /// <param name="run">Executor running the parts, such as a thread
+        /// pool or std::for_each with std::execution::par over the part
+        /// indices. A new thread per part if empty.</param>
+        if (!threshold) {
+            parallel.reset();
+            return;
         }
+
+        if (!tasks) { tasks = std::thread::hardware_concurrency(); }
+        if (!tasks) { tasks = 1; }
+        if (!run) { run = run_threads; }
+
+        parallel.reset(new parallel_settings{ threshold, tasks, std::move(run) });
     }
 
-    void clear_rank() {
+    std::size_t get_parallel_threshold() const {
         /// <summary>
-        /// Clear the contents of rank.
+        /// Returns the fewest roots consolidated in parallel, 0 if
+        /// consolidation always runs on the calling thread.
         /// </summary>
-        for (auto &elem : rank) { elem = nullptr; }
+        return parallel ? parallel->threshold : 0;
     }
 
-    std::size_t get_size() {
+    void print_heap() { 
         /// <summary>
-        /// Returns the number of elements contained in the
-        /// FibonacciHeap.
+        /// Print the contents of this collection.
         /// </summary>
-        /// <returns>The number of elements contained in the
-        /// FibonacciHeap.</returns>
-        return size;
+        if (!min_node) { return; }
+
+        std::cout << "min_node: " << min_node->value << std::endl;
+        fhNode<T, Key> *root = min_node;
+        do {
+            root->print();
+            root = root->right;
+        } while (root != min_node);
     }
 
-    bool is_empty() {
+    void set_min() {
         /// <summary>
-        /// Returns true if there are no elements in the collection;
-        /// otherwise false.
+        /// Set the min_node to the root with the lowest priority.
         /// </summary>
-        /// <returns>True if there are no elements in the collection;
-        /// otherwise false.</returns>
+        if (!min_node) { return; }
+
+        fhNode<T, Key> *root = min_node->right;
+        while (root != min_node) {
+            if (less(root->priority, min_node->priority))
+                min_node = root;
+            root = root->right;
+        }
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node from the collection, and give the memory
+        /// held by the collection back to its allocator. The trees are
+        /// walked without recursion, so every node is visited once no
+        /// matter how deep the trees are. Values without a destructor
+        /// to run are not walked at all, the slabs are simply released.
+        /// </summary>
+        fhNode<T, Key> *curr_node = std::is_trivially_destructible<T>::value ? nullptr : min_node, *next_node;
+
+        // Break the circular root list, so the walk ends after the 
+        // last node.
+        if (curr_node) { curr_node->left->right = nullptr; }
+
+        while (curr_node) {
+            // Splice the node's children into the list being walked
+            // directly after the node, so they are freed next.
+            if (curr_node->child) {
+                curr_node->child->left->right = curr_node->right;
+                curr_node->right = curr_node->child;
+            }
+
+            next_node = curr_node->right;
+            pool.deallocate(curr_node);
+            curr_node = next_node;
+        }
+
+        pool.release();
+        min_node = nullptr;
+        size = 0;
+
+        if (incremental) { *incremental = consolidation_state(incremental->budget); }
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the
+        /// FibonacciHeap.
+        /// </summary>
+        /// <returns>The number of elements contained in the
+        /// FibonacciHeap.</returns>
+        return size;
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false.
+        /// </summary>
+        /// <returns>True if there are no elements in the collection;
+        /// otherwise false.</returns>
         return !(size); 
     }
 
-    void change_priority(const T &key, const long long &old_priority, const long long &new_priority) {
+    void change_priority(const T &key, const Key &old_priority, const Key &new_priority) {
         /// <summary>
         /// Change the priority of a key.
         /// </summary>
         /// <param name="key">Value contained by the target node.</param>
         /// <param name="old_priority">Old priority of the key.</param>
         /// <param name="new_priority">New priority of the key.</param>
-        std::shared_ptr<fhNode<T>> parent_node, curr_node, child;
+        timer timed(*this, fhStats::op_change_priority);
+        fhNode<T, Key> *curr_node;
 
         // Find the node in the collection.
         curr_node = find(key, old_priority);
 
         // If the node being searched for was not found exit.
-        if (!(curr_node.use_count())) { return; }
+        if (!curr_node) { return; }
+
+        change_priority(curr_node, new_priority);
+    }
+
+    void change_priority(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Change the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        if (!node) { return; }
+
+        change_priority(node.node, new_priority);
+    }
+
+    void decrease_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Lower the priority of the node referred to by a handle, without
+        /// searching the heap for it.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node, should not
+        /// be greater than its current priority.</param>
+        change_priority(node, new_priority);
+    }
+
+    void increase_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Raise the priority of the node referred to by a handle, without
+        /// searching the heap for it.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node, should not
+        /// be less than its current priority.</param>
+        change_priority(node, new_priority);
+    }
+
+    template <typename InputIt>
+    void decrease_keys(InputIt first, InputIt last) {
+        /// <summary>
+        /// Lower the priorities of many nodes at once. Every priority is
+        /// changed first, then the nodes that are ordered before their
+        /// parent are cut in one pass, and the minimum is updated once.
+        /// A node given twice keeps the last priority, a raised priority
+        /// is changed as if by increase_key.
+        /// </summary>
+        /// <param name="first">Iterator to the first std::pair of a
+        /// handle and the node's new priority.</param>
+        /// <param name="last">Iterator past the last pair.</param>
+        timer timed(*this, fhStats::op_decrease_keys);
+        std::vector<fhNode<T, Key>*> changed;
+
+        for (; first != last; ++first) {
+            fhNode<T, Key> *node = first->first.node;
+            const Key &priority = first->second;
+
+            // A raised priority needs the node's children checked, which
+            // relies on the heap being in order, so the nodes changed so
+            // far are cut first and the node is changed on its own.
+            if (less(node->priority, priority)) {
+                cut_decreased(changed);
+                changed.clear();
+                change_priority(node, first->second);
+                continue;
+            }
+
+            node->priority = priority;
+            changed.push_back(node);
+        }
+
+        cut_decreased(changed);
+        if (incremental) { consolidate_step(0); }
+    }
+
+    void erase(const handle &node) {
+        /// <summary>
+        /// Remove the node referred to by a handle from the collection. The
+        /// handle is no longer valid after this call.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        if (!node) { return; }
+
+        timer timed(*this, fhStats::op_erase);
+        fhNode<T, Key> *curr_node = node.node;
+        fhNode<T, Key> *parent_node = curr_node->parent;
+
+        // Cut the tree rooted at curr_node and meld it into the root
+        // list, as if its priority was lowered past every other node.
+        if (parent_node) {
+            cut(curr_node);
+            mark_utility(parent_node);
+        }
+
+        // curr_node is now a root, so it can be removed the same way
+        // the minimum is.
+        min_node = curr_node;
+        delete_min();
+    }
+
+    const T& get_value(const handle &node) const {
+        /// <summary>
+        /// Returns the value contained by the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <returns>Value contained by the node.</returns>
+        return node.node->value;
+    }
+
+    Key get_priority(const handle &node) const {
+        /// <summary>
+        /// Returns the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <returns>Priority of the node.</returns>
+        return node.node->priority;
+    }
+
+    void change_priority(fhNode<T, Key> *curr_node, const Key &new_priority) {
+        /// <summary>
+        /// Change the priority of a node in the collection.
+        /// </summary>
+        /// <param name="curr_node">Node having its priority changed.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        timer timed(*this, fhStats::op_change_priority);
+        fhNode<T, Key> *parent_node, *child, *next_child;
+        fhNode<T, Key> *changed_node = curr_node;
+        Key old_priority = curr_node->priority;
+        bool was_min = (curr_node == min_node);
+        unsigned cuts = 0;
 
         // Update the curr_node's priority, and set the parent_node.
         curr_node->priority = new_priority;
@@ -394,16 +1283,11 @@ public:
 
         // If the curr_nodes priority has a chance of being less than 
         // the parents priority.
-        if (new_priority < old_priority) {
+        if (less(changed_node->priority, old_priority)) {
             // While the curr_node has a parent, and the parents
             // priority is greater than the current node's priority.
-            while (parent_node.use_count() && (curr_node->priority < parent_node->priority)) {
-                auto it = std::find(parent_node->children.begin(), parent_node->children.end(), curr_node);
-                parent_node->children.erase(it);
-                roots.push_back(curr_node);
-                curr_node->parent = nullptr;
-                curr_node->marked = false;
-                set_degree(parent_node);
+            while (parent_node && less(curr_node->priority, parent_node->priority)) {
+                cut(curr_node);
                 mark_utility(parent_node);
 
                 // Set curr_node and parent_node appropriately.
@@ -414,33 +1298,59 @@ public:
 
         // If the curr_node's child has a chance of being less than 
         // the curr_node's priority.
-        if (new_priority > old_priority) {
-
-            for (size_t index = 0; index < curr_node->children.size(); ++index) {
-                child = curr_node->children[index];
+        if (less(old_priority, changed_node->priority) && curr_node->child) {
+            // Detach the child list, and walk it adding back the 
+            // children that still satisfy the heap property.
+            child = curr_node->child;
+            child->left->right = nullptr;
+            curr_node->child = nullptr;
+
+            while (child) {
+                next_child = child->right;
+                child->left = child;
+                child->right = child;
 
                 // Make sure no child has lower priority than the
                 // node's parent.
-                if (child->priority < curr_node->priority) {
+                if (less(child->priority, curr_node->priority)) {
                     // Cut the tree rooted at child, meld into root
                     // list.
-                    auto it = std::find(curr_node->children.begin(), curr_node->children.end(), child);
-                    curr_node->children.erase(it);
-                    roots.push_back(child);
                     child->parent = nullptr;
                     child->marked = false;
-                    set_degree(curr_node);
-                    mark_utility(curr_node);
-                    index--;
+                    add_root(child);
+                    ++cuts;
+                }
+                else if (curr_node->child) {
+                    fhNode<T, Key>::splice(curr_node->child, child);
                 }
+                else {
+                    curr_node->child = child;
+                }
+
+                child = next_child;
+            }
+
+            if (cuts) { unrank(curr_node); }
+            curr_node->degree = static_cast<std::uint8_t>(curr_node->degree - cuts);
+            for (unsigned i = 0; i < cuts; ++i) {
+                mark_utility(curr_node);
             }
         }
 
-        // In case the min_nodes priority changed reset the min_node.
-        set_min();
+        // Only the changed node can become the new minimum, unless the
+        // minimum itself was raised, then every root has to be checked.
+        if (was_min && less(old_priority, changed_node->priority)) {
+            set_min();
+        }
+        else if (less(changed_node->priority, min_node->priority)) {
+            min_node = changed_node;
+        }
+
+        // Link the roots the cuts added.
+        if (incremental) { consolidate_step(0); }
     }
 
-    std::shared_ptr<fhNode<T>> find(const T& key, const long long& priority) {
+    fhNode<T, Key>* find(const T& key, const Key& priority) {
         /// <summary>
         /// Given a key, finds and returns a pointer to that key.
         /// </summary>
@@ -449,176 +1359,1049 @@ public:
         /// node.</param>
         /// <returns>Pointer to target node;
         /// otherwise a nullptr.</returns>
-        std::shared_ptr<fhNode<T>> node;
+        fhNode<T, Key> *node = nullptr;
+        const Key &target = priority;
+
+        // If the collection is empty there is nothing to find.
+        if (!min_node) { return nullptr; }
         
         // Search each tree for the key
-        for (auto &root : roots) {
+        fhNode<T, Key> *root = min_node;
+        do {
             // If the root node matches the node being searched
             // for, return that node.
-            if (root->value == key && root->priority == priority) {
+            if (root->value == key && !less(root->priority, target) && !less(target, root->priority)) {
                 return root;
             }
 
             // Because of the property of heaps if the priority 
             // is greater than the target priority we can skip
-            // looking through this tree.
-            if (root->priority > priority) {
-                continue;
-            }
-
-            // If this root has children search them.
-            if (root->children.size() != 0) {
-                node = root->search(key, priority);
+            // looking through this tree, otherwise search the
+            // root's children.
+            if (!less(target, root->priority)) {
+                node = root->search(key, target, this->compare());
             }
 
             // If node is not the nullptr than the correct node
             // was found and should be returned.
-            if (node.use_count() != 0) {
+            if (node) {
                 return node;
             }
-        }
+
+            root = root->right;
+        } while (root != min_node);
 
         // After every element has been searched and a match has
         // not been found return the nullptr.
         return nullptr;
     }
 
-    void set_degree(std::shared_ptr<fhNode<T>> &node) {
+    fhNode<T, Key>* find_min() {
         /// <summary>
-        /// Determine the degree of the current node, given it's children.
-        /// Set the correct degree of each of the parents if necessary.
+        /// Return the minimum node in the priority queue, without removing it.
         /// </summary>
-        /// <param name="node">Node having its 
-        /// degree updated.</param>
-
-        // determine the degree of the node before altering the node.
-        unsigned prev_degree = node->degree;
-        node->degree = 0;
-        
-        // Check each of the node's children and update the node's
-        // degree when necessary.
-        for (const auto &child : node->children) {
-            if (child->degree >= node->degree) {
-                node->degree = child->degree + 1;
-            }
-        }
-
-        // If the node's degree has changed, and the node has a 
-        // parent update the parent's degree when necessary.
-        if (prev_degree != node->degree && node->parent.use_count() != 0) {
-            set_degree(node->parent);
-        }
+        /// <returns>Pointer to the minimum 
+        /// node in the collection.</returns>
+        return min_node; 
     }
 
-    std::shared_ptr<fhNode<T>> find_min() {
+    const fhNode<T, Key>* find_min() const {
         /// <summary>
-        /// Return the minimum node in the priority queue, without removing it.
+        /// Return the minimum node of a const collection, without
+        /// removing it.
         /// </summary>
-        /// <returns>Pointer to the minimum 
+        /// <returns>Pointer to the minimum
         /// node in the collection.</returns>
-        return min_node; 
+        return min_node;
     }
 
-    void mark_utility(std::shared_ptr<fhNode<T>> &node) {
+    void mark_utility(fhNode<T, Key> *node) {
         /// <summary>
-        /// Recursive utility function that will recurse through the tree and
-        /// either mark or remove marked node's.
+        /// Utility function that will walk up the tree and either mark
+        /// or remove marked node's.
         /// </summary>
         /// <param name="node">Node being marked 
         /// or removed from
         /// the heap.</param>
 
         // Set parent_node equal to the node's parent.
-        std::shared_ptr<fhNode<T>> parent_node = node->parent;
+        fhNode<T, Key> *parent_node = node->parent;
+
+        // Number of marked nodes cut, for the statistics.
+        std::uint64_t depth = 0;
 
-        // Exit mark_utility if the node is the root of the tree,
-        // otherwise process the node.
-        if(parent_node.use_count() != 0){
+        // Stop once the node is the root of the tree, otherwise
+        // process the node.
+        while (parent_node) {
 
-            // If the node is not marked, mark it and exit the 
-            // function.
+            // If the node is not marked, mark it and stop.
             if (!(node->marked)) {
                 node->marked = true;
-                return;
+                break;
             }
 
             // Cut the tree rooted at node, meld it into the root 
-            // list, set the parents degree than recursively call the
-            // mark_utility function.
-            auto it = std::find(parent_node->children.begin(), parent_node->children.end(), node);
-            parent_node->children.erase(it);
-            roots.push_back(node);
-            node->parent = nullptr;
-            node->marked = false;
-            set_degree(parent_node);
-            mark_utility(parent_node);
+            // list, then process its parent the same way.
+            cut(node);
+            ++depth;
+            node = parent_node;
+            parent_node = node->parent;
         }
+
+        record_cascade(depth);
     }
 
-  std::shared_ptr<fhNode<T>> extract_min() {
+    std::pair<T, Key> extract_min() {
         /// <summary>
-        /// Return the minimum node in the collection, the minimum
-        ///  node will be removed from the collection after this
-        ///  method call.
+        /// Return the value and priority of the minimum node in the
+        /// collection, the minimum node will be removed from the 
+        /// collection after this method call. Throws std::out_of_range
+        /// if the collection is empty.
         /// </summary>
-        /// <returns>Pointer to the minimum 
+        /// <returns>Value and priority of the minimum 
         /// node in the collection.</returns>
-        std::shared_ptr<fhNode<T>> rtn_val = min_node;
-        delete_min();
+        if (!min_node) { throw std::out_of_range("extract_min called on an empty FibonacciHeap"); }
+
+        timer timed(*this, fhStats::op_delete_min);
+        fhNode<T, Key> *old_min = remove_min();
+        std::pair<T, Key> rtn_val(std::move(old_min->value), old_min->priority);
+        pool.deallocate(old_min);
         return rtn_val;
     }
 
-    std::vector<std::shared_ptr<fhNode<T>>> get_roots() {
+    bool extract_min(T &value) {
+        /// <summary>
+        /// Move the value of the minimum node in the collection into
+        /// value, the minimum node will be removed from the collection
+        /// after this method call.
+        /// </summary>
+        /// <param name="value">Object the minimum value is moved 
+        /// into.</param>
+        /// <returns>True if a value was extracted; false if the
+        /// collection was empty.</returns>
+        timer timed(*this, fhStats::op_delete_min);
+        fhNode<T, Key> *old_min = remove_min();
+        if (!old_min) { return false; }
+
+        value = std::move(old_min->value);
+        pool.deallocate(old_min);
+        return true;
+    }
+
+    template <typename OutputIt>
+    OutputIt extract_k(std::size_t k, OutputIt out) {
+        /// <summary>
+        /// Remove the k nodes with the lowest priorities from the
+        /// collection, writing their values and priorities to out in
+        /// order. The trees are consolidated once for the whole batch,
+        /// instead of once per node.
+        /// </summary>
+        /// <param name="k">Number of nodes to remove, every node is
+        /// removed if the collection holds fewer.</param>
+        /// <param name="out">Iterator the std::pair of each node's value
+        /// and priority is written to.</param>
+        /// <returns>Iterator past the last pair written.</returns>
+        timer timed(*this, fhStats::op_extract_k);
+        if (!min_node || !k) { return out; }
+        if (k > size) { k = size; }
+
+        // The next lowest node is always a root or a child of a node
+        // already selected, so the candidates start as the roots and
+        // gain the children of every node selected. Ordered with the
+        // lowest priority at the front.
+        auto later = [this](const fhNode<T, Key> *a, const fhNode<T, Key> *b) {
+            return less(b->priority, a->priority);
+        };
+        std::vector<fhNode<T, Key>*> candidates = get_roots();
+        std::make_heap(candidates.begin(), candidates.end(), later);
+
+        std::vector<fhNode<T, Key>*> selected;
+        selected.reserve(k);
+
+        while (selected.size() < k) {
+            std::pop_heap(candidates.begin(), candidates.end(), later);
+            fhNode<T, Key> *node = candidates.back();
+            candidates.pop_back();
+            selected.push_back(node);
+
+            if (node->child) {
+                fhNode<T, Key> *child = node->child;
+                do {
+                    candidates.push_back(child);
+                    std::push_heap(candidates.begin(), candidates.end(), later);
+                    child = child->right;
+                } while (child != node->child);
+            }
+        }
+
+        // Every selected node comes after its parent, whose removal
+        // made it a root. So each removal only melds the node's
+        // children into the root list, and no cut is ever needed.
+        for (fhNode<T, Key> *node : selected) {
+            *out = std::pair<T, Key>(std::move(node->value), node->priority);
+            ++out;
+
+            if (node->child) {
+                fhNode<T, Key> *child = node->child;
+                do {
+                    child->parent = nullptr;
+                    child = child->right;
+                } while (child != node->child);
+
+                fhNode<T, Key>::splice(node, node->child);
+                node->child = nullptr;
+            }
+
+            if (node->right == node) {
+                min_node = nullptr;
+            }
+            else {
+                min_node = node->right;
+                node->unlink();
+            }
+            pool.deallocate(node);
+        }
+        size -= k;
+
+        // The removed nodes may have been ranked, the consolidation
+        // ranks the roots left again.
+        if (incremental) { *incremental = consolidation_state(incremental->budget); }
+
+        // Consolidate once, which also sets the new minimum.
+        consolidate_tree();
+        return out;
+    }
+
+    template <typename Predicate, typename OutputIt,
+              typename = typename std::enable_if<std::is_invocable<Predicate&, const Key&>::value>::type>
+    OutputIt extract_while(Predicate pred, OutputIt out) {
+        /// <summary>
+        /// Remove every node whose priority satisfies pred, writing their
+        /// values and priorities to out, parents before their children
+        /// and in no particular order otherwise. pred must hold for every
+        /// priority ordered before one it holds for, such as every
+        /// priority below a cutoff, so the trees are pruned at the first
+        /// node it rejects, the same way find skips them. pred must not
+        /// throw.
+        /// </summary>
+        /// <param name="pred">Callable taking a priority and returning
+        /// true if its node is removed.</param>
+        /// <param name="out">Iterator the std::pair of each node's value
+        /// and priority is written to.</param>
+        /// <returns>Iterator past the last pair written.</returns>
+        return extract_top([&pred](const Key &priority) { return pred(priority); }, out);
+    }
+
+    template <typename OutputIt>
+    OutputIt extract_while(const Key &threshold, OutputIt out) {
+        /// <summary>
+        /// Remove every node whose priority is not ordered after
+        /// threshold, writing their values and priorities to out, see
+        /// extract_while(pred, out).
+        /// </summary>
+        /// <param name="threshold">Highest priority removed.</param>
+        /// <param name="out">Iterator the std::pair of each node's value
+        /// and priority is written to.</param>
+        /// <returns>Iterator past the last pair written.</returns>
+        return extract_top([this, &threshold](const Key &priority) { return !less(threshold, priority); }, out);
+    }
+
+    template <typename Predicate>
+    std::size_t erase_if(Predicate pred) {
+        /// <summary>
+        /// Remove every node whose value and priority satisfy pred. Every
+        /// node is visited once, then each one removed is cut out of its
+        /// tree, and the trees are consolidated once for the whole batch.
+        /// pred must not change the collection.
+        /// </summary>
+        /// <param name="pred">Callable taking a value and a priority and
+        /// returning true if their node is removed.</param>
+        /// <returns>Number of nodes removed.</returns>
+        timer timed(*this, fhStats::op_erase_if);
+        std::vector<fhNode<T, Key>*> matched;
+
+        for_each_node([this, &pred, &matched](fhNode<T, Key> *node) {
+            const fhNode<T, Key> &curr = *node;
+            if (pred(curr.value, curr.priority)) { matched.push_back(node); }
+        });
+        if (matched.empty()) { return 0; }
+
+        for (fhNode<T, Key> *node : matched) {
+            // Cut the node out of its tree as erase does, then meld its
+            // children into the root list without consolidating.
+            fhNode<T, Key> *parent_node = node->parent;
+            if (parent_node) {
+                cut(node);
+                mark_utility(parent_node);
+            }
+
+            if (node->child) {
+                fhNode<T, Key> *child = node->child;
+                do {
+                    child->parent = nullptr;
+                    child = child->right;
+                } while (child != node->child);
+
+                fhNode<T, Key>::splice(node, node->child);
+                node->child = nullptr;
+            }
+
+            if (node->right == node) {
+                min_node = nullptr;
+            }
+            else {
+                if (min_node == node) { min_node = node->right; }
+                node->unlink();
+            }
+            pool.deallocate(node);
+        }
+        size -= matched.size();
+
+        // The removed nodes may have been ranked, the consolidation
+        // ranks the roots left again.
+        if (incremental) { *incremental = consolidation_state(incremental->budget); }
+
+        // Consolidate once, which also sets the new minimum.
+        consolidate_tree();
+        return matched.size();
+    }
+
+    void shift_all_keys(const Key &delta) {
+        /// <summary>
+        /// Add delta to the priority of every node in one pass over the
+        /// nodes, without moving any of them, so the trees and handles
+        /// stay as they are. Needs arithmetic priorities ordered by
+        /// std::less or std::greater, whose order adding the same delta
+        /// to both priorities never changes. If an integer priority
+        /// would overflow, std::overflow_error is thrown before any
+        /// priority is changed. Floating point priorities are rounded.
+        /// </summary>
+        /// <param name="delta">Amount added to every priority.</param>
+        static_assert(shiftable_keys, "shift_all_keys needs arithmetic priorities ordered by std::less or std::greater");
+        if (!min_node || delta == Key()) { return; }
+
+        if constexpr (std::is_integral<Key>::value) {
+            // The priorities a delta can be added to without overflow.
+            const Key highest = std::numeric_limits<Key>::max() - (delta > Key() ? delta : Key());
+            const Key lowest = std::numeric_limits<Key>::min() - (delta < Key() ? delta : Key());
+            bool overflow = false;
+            for_each_node([&overflow, &highest, &lowest](fhNode<T, Key> *node) {
+                if (node->priority > highest || node->priority < lowest) { overflow = true; }
+            });
+            if (overflow) { throw std::overflow_error("shift_all_keys: a priority would overflow"); }
+        }
+        for_each_node([&delta](fhNode<T, Key> *node) { node->priority += delta; });
+    }
+
+    FibonacciHeap<T, Key, Compare, Alloc> clone() const {
+        /// <summary>
+        /// Returns a deep copy of this collection, which shares no nodes
+        /// with it. The copied nodes are allocated in one block.
+        /// </summary>
+        /// <returns>Copy of this collection.</returns>
+        return FibonacciHeap<T, Key, Compare, Alloc>(*this);
+    }
+
+    fhStats get_stats() const {
+        /// <summary>
+        /// Returns a copy of the statistics recorded by this collection,
+        /// all zeroes unless FH_ENABLE_STATS was defined before this
+        /// file was included.
+        /// </summary>
+        /// <returns>Statistics since construction or the last
+        /// reset_stats.</returns>
+        return fhStatsRecorder::get_stats();
+    }
+
+    void reset_stats() {
+        /// <summary>
+        /// Set every statistic recorded by this collection back to zero.
+        /// </summary>
+        fhStatsRecorder::reset_stats();
+    }
+
+    Compare get_compare() const {
+        /// <summary>
+        /// Returns the ordering of the priorities.
+        /// </summary>
+        /// <returns>Ordering of the priorities.</returns>
+        return this->compare();
+    }
+
+    Alloc get_allocator() const {
+        /// <summary>
+        /// Returns the allocator used for the nodes.
+        /// </summary>
+        /// <returns>Allocator used for the nodes.</returns>
+        return pool.get_allocator();
+    }
+
+    std::vector<fhNode<T, Key>*> get_roots() {
         /// <summary>
         /// Returns this collections roots.
         /// </summary>
         /// <returns>Collection of
         /// this roots.</returns>
+        std::vector<fhNode<T, Key>*> roots;
+
+        if (min_node) {
+            fhNode<T, Key> *root = min_node;
+            do {
+                roots.push_back(root);
+                root = root->right;
+            } while (root != min_node);
+        }
+
         return roots;
     }
 
-    FibonacciHeap<T> operator+(FibonacciHeap<T> &other) {
+    void merge(FibonacciHeap<T, Key, Compare, Alloc> &&other) {
         /// <summary>
-        /// Combine two FibonacciHeaps.
+        /// Combine two FibonacciHeaps in O(1), every node is moved out 
+        /// of the other collection leaving it empty. Handles to the 
+        /// other collection's nodes refer to this collection afterwards.
+        /// With incremental consolidation the
+        /// other collection's r roots are linked here, in O(r).
         /// </summary>
-        /// <typeparam name="T">Other collection being
-        /// combined with the current
-        /// collection.</typeparam>
-        FibonacciHeap<T> rtn_val(*this);
+        /// <param name="other">Collection being combined with the 
+        /// current collection.</param>
+
+        // If the other collection is empty there is nothing to
+        // combine.
+        if (!other.min_node || &other == this) { return; }
+
+        timer timed(*this, fhStats::op_merge);
+
+        // The nodes are moved by taking over the other pool, which is
+        // only possible when both pools use the same allocator.
+        // Otherwise combine with a copy made with this allocator, 
+        // the other collection's handles are not kept in that case.
+        if constexpr (!std::allocator_traits<Alloc>::is_always_equal::value) {
+            if (!(pool.get_allocator() == other.pool.get_allocator())) {
+                merge_copy(other);
+                return;
+            }
+        }
+        pool.steal(other.pool);
 
-        // Update min_node when necessary.
-        if (other.min_node->priority < rtn_val.min_node->priority) {
-            rtn_val.min_node = other.min_node;
+        // Splice the other collection's root list into this 
+        // collection's root list, and update min_node when 
+        // necessary.
+        if (!min_node) {
+            min_node = other.min_node;
+        }
+        else {
+            fhNode<T, Key>::splice(min_node, other.min_node);
+            if (less(other.min_node->priority, min_node->priority)) {
+                min_node = other.min_node;
+            }
         }
 
-        // Push each root from the other collection into the new 
-        // collection.
-        for (auto &root : other.roots) {
-            rtn_val.roots.push_back(root);
+        size += other.size;
+        other.min_node = nullptr;
+        other.size = 0;
+
+        // The other collection's roots have not been ranked here, they
+        // are linked now, walking no further than its roots.
+        if (incremental) {
+            incremental->pending = true;
+            incremental->added += size;
+            consolidate_step(0);
         }
+        if (other.incremental) { *other.incremental = consolidation_state(other.incremental->budget); }
+    }
 
-        return rtn_val;
+    void lend_free_nodes(FibonacciHeap<T, Key, Compare, Alloc> &other) {
+        /// <summary>
+        /// Let another collection insert into the memory of nodes this
+        /// collection has deleted, instead of requesting more. Meant for
+        /// collections that are merged into this one over and over, this
+        /// collection must outlive the other's nodes unless they are
+        /// merged back, and both must use equal allocators.
+        /// </summary>
+        /// <param name="other">Collection the free nodes are lent to.</param>
+        if constexpr (!std::allocator_traits<Alloc>::is_always_equal::value) {
+            if (!(pool.get_allocator() == other.pool.get_allocator())) { return; }
+        }
+        pool.lend_free(other.pool);
     }
 
- FibonacciHeap<T>& operator+=(FibonacciHeap<T> &other) {
+    FibonacciHeap<T, Key, Compare, Alloc>& operator+=(FibonacciHeap<T, Key, Compare, Alloc> &other) {
         /// <summary>
-        /// Combine two FibonacciHeaps.
+        /// Combine two FibonacciHeaps, every node is moved out of the
+        /// other collection leaving it empty.
         /// </summary>
         /// <typeparam name="T">Other collection being
         /// combined with the current
         /// collection.</typeparam>
+        merge(std::move(other));
+        return *this;
+    }
 
-        // Update min_node when necessary.
-        if (other.min_node->priority < min_node->priority) {
-            min_node = other.min_node;
+    FibonacciHeap<T, Key, Compare, Alloc>& operator+=(FibonacciHeap<T, Key, Compare, Alloc> &&other) {
+        /// <summary>
+        /// Combine two FibonacciHeaps, every node is moved out of the
+        /// other collection leaving it empty.
+        /// </summary>
+        /// <typeparam name="T">Other collection being
+        /// combined with the current
+        /// collection.</typeparam>
+        merge(std::move(other));
+        return *this;
+    }
+
+    friend FibonacciHeap<T, Key, Compare, Alloc> operator+(FibonacciHeap<T, Key, Compare, Alloc> lhs,
+                                                           FibonacciHeap<T, Key, Compare, Alloc> rhs) {
+        /// <summary>
+        /// Combine two FibonacciHeaps. Each operand is only copied when
+        /// it is not an rvalue, so combining temporaries copies nothing.
+        /// </summary>
+        /// <param name="lhs">First collection being combined.</param>
+        /// <param name="rhs">Second collection being combined.</param>
+        /// <returns>Collection holding the nodes of both.</returns>
+        lhs.merge(std::move(rhs));
+        return lhs;
+    }
+
+private:
+    bool less(const Key &a, const Key &b) const {
+        /// <summary>
+        /// Returns true if priority a is ordered before priority b.
+        /// </summary>
+        return this->compare()(a, b);
+    }
+
+    template <typename Visit>
+    void for_each_node(Visit visit) {
+        /// <summary>
+        /// Call visit on every node, parents before their children,
+        /// walking the trees without recursion. visit must not change
+        /// the trees.
+        /// </summary>
+        fhNode<T, Key> *curr_node = min_node;
+
+        while (curr_node) {
+            visit(curr_node);
+
+            if (curr_node->child) {
+                curr_node = curr_node->child;
+                continue;
+            }
+
+            // Move on to the next sibling, climbing up to the first
+            // ancestor that still has siblings left to visit.
+            while (curr_node) {
+                fhNode<T, Key> *first_sibling = curr_node->parent ? curr_node->parent->child : min_node;
+                if (curr_node->right != first_sibling) {
+                    curr_node = curr_node->right;
+                    break;
+                }
+                curr_node = curr_node->parent;
+            }
+        }
+    }
+
+    template <typename Predicate, typename OutputIt>
+    OutputIt extract_top(Predicate pred, OutputIt out) {
+        /// <summary>
+        /// Remove every node whose priority, as kept in the node,
+        /// satisfies pred, which holds for every priority ordered before
+        /// one it holds for. A node is only removed with its parent, so
+        /// its children that stay become roots and no cut is needed.
+        /// </summary>
+        /// <param name="pred">Callable taking a node's priority.</param>
+        /// <param name="out">Iterator the pairs are written to.</param>
+        /// <returns>Iterator past the last pair written.</returns>
+        timer timed(*this, fhStats::op_extract_while);
+
+        // Nothing is ordered before the minimum.
+        if (!min_node || !pred(min_node->priority)) { return out; }
+
+        // Take the roots being removed out of the root list, keeping
+        // any root that stays as min_node.
+        std::vector<fhNode<T, Key>*> selected;
+        fhNode<T, Key> *root = min_node, *last_root = min_node->left, *next_root, *kept = nullptr;
+        bool more = true;
+
+        while (more) {
+            more = (root != last_root);
+            next_root = root->right;
+
+            if (pred(root->priority)) {
+                root->unlink();
+                selected.push_back(root);
+            }
+            else {
+                kept = root;
+            }
+            root = next_root;
         }
+        min_node = kept;
+
+        // Every child of a removed node is removed too, or melded into
+        // the root list with its whole subtree.
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+            fhNode<T, Key> *node = selected[i];
+
+            if (fhNode<T, Key> *child = node->child) {
+                child->left->right = nullptr;
+                node->child = nullptr;
+
+                while (child) {
+                    fhNode<T, Key> *next_child = child->right;
+                    child->parent = nullptr;
+                    child->left = child;
+                    child->right = child;
 
-        // Push each root from the other collection into the new 
-        // collection.
-        for (auto &root : other.roots) {
-            roots.push_back(root);
+                    if (pred(child->priority)) {
+                        selected.push_back(child);
+                    }
+                    else {
+                        child->marked = false;
+                        add_root(child);
+                    }
+                    child = next_child;
+                }
+            }
+
+            *out = std::pair<T, Key>(std::move(node->value), node->priority);
+            ++out;
+            pool.deallocate(node);
         }
+        size -= selected.size();
 
-        return *this;
+        // The removed roots may have been ranked, the consolidation
+        // ranks the roots left again.
+        if (incremental) { *incremental = consolidation_state(incremental->budget); }
+
+        // Consolidate once, which also sets the new minimum.
+        consolidate_tree();
+        return out;
+    }
+
+    void add_root(fhNode<T, Key> *node) {
+        /// <summary>
+        /// Meld a tree into the root list, and update min_node when
+        /// necessary.
+        /// </summary>
+        /// <param name="node">Root of the tree being melded.</param>
+        if (incremental) {
+            incremental->pending = true;
+            ++incremental->added;
+        }
+
+        if (!min_node) {
+            node->left = node;
+            node->right = node;
+            min_node = node;
+            return;
+        }
+
+        fhNode<T, Key>::splice(min_node, node);
+        if (less(node->priority, min_node->priority)) {
+            min_node = node;
+        }
+    }
+
+    void link(fhNode<T, Key> *child, fhNode<T, Key> *parent) {
+        /// <summary>
+        /// Make the root child a child of the root parent.
+        /// </summary>
+        /// <param name="child">Root becoming a child.</param>
+        /// <param name="parent">Root the child is added to.</param>
+        child->parent = parent;
+        child->marked = false;
+
+        if (parent->child) {
+            fhNode<T, Key>::splice(parent->child, child);
+        }
+        else {
+            parent->child = child;
+        }
+
+        ++parent->degree;
+    }
+
+    void cut(fhNode<T, Key> *node) {
+        /// <summary>
+        /// Cut the tree rooted at node from its parent, and meld it into
+        /// the root list.
+        /// </summary>
+        /// <param name="node">Root of the tree being cut.</param>
+        fhNode<T, Key> *parent_node = node->parent;
+
+        if (parent_node->child == node) {
+            parent_node->child = (node->right != node) ? node->right : nullptr;
+        }
+        node->unlink();
+        unrank(parent_node);
+        --parent_node->degree;
+        node->parent = nullptr;
+        node->marked = false;
+        add_root(node);
+    }
+
+    void cut_decreased(const std::vector<fhNode<T, Key>*> &nodes) {
+        /// <summary>
+        /// Restore the heap after the priorities of nodes were lowered
+        /// without moving them. Every node ordered before its parent is
+        /// cut once, then the minimum is updated in a single pass.
+        /// </summary>
+        /// <param name="nodes">Nodes whose priorities were lowered, a
+        /// node given twice is only cut once.</param>
+
+        // A node cut by mark_utility has no parent by the time it is
+        // reached.
+        for (fhNode<T, Key> *node : nodes) {
+            fhNode<T, Key> *parent_node = node->parent;
+            if (!parent_node || !less(node->priority, parent_node->priority)) { continue; }
+
+            cut(node);
+            mark_utility(parent_node);
+        }
+
+        // Only a lowered node can become the new minimum.
+        for (fhNode<T, Key> *node : nodes) {
+            if (!node->parent && less(node->priority, min_node->priority)) {
+                min_node = node;
+            }
+        }
+    }
+
+    fhNode<T, Key>* remove_min() {
+        /// <summary>
+        /// Remove min_node from the collection and consolidate trees so 
+        /// that no two roots have the same rank.
+        /// </summary>
+        /// <returns>The removed node.</returns>
+        fhNode<T, Key> *old_min = min_node;
+
+        // If the collection is empty prematurely exit the function.
+        if (!old_min) { return nullptr; }
+
+        if (incremental) {
+            unrank(old_min);
+            if (incremental->cursor == old_min) { incremental->cursor = nullptr; }
+            if (old_min->child) { incremental->pending = true; }
+        }
+
+        // Meld the children into the root list
+        if (old_min->child) {
+            fhNode<T, Key> *child = old_min->child;
+            do {
+                child->parent = nullptr;
+                child = child->right;
+            } while (child != old_min->child);
+
+            fhNode<T, Key>::splice(old_min, old_min->child);
+            old_min->child = nullptr;
+        }
+
+        // Remove old_min from the root list, and consolidate the trees 
+        // so that no two roots have the same rank, which also sets the
+        // new minimum.
+        if (old_min->right == old_min) {
+            min_node = nullptr;
+        }
+        else {
+            min_node = old_min->right;
+            old_min->unlink();
+
+            // Incrementally only the roots this removal added are linked,
+            // the others are ranked already, so at most max_degree roots
+            // are scanned for the minimum.
+            if (incremental) {
+                consolidate_step(old_min->degree);
+                set_min();
+            }
+            else {
+                consolidate_tree();
+            }
+        }
+
+        old_min->degree = 0;
+        old_min->marked = false;
+        --size;
+
+        return old_min;
+    }
+
+    void rank_root(rank_table &table, fhNode<T, Key> *root) {
+        /// <summary>
+        /// Add a tree to a degree table, linking it with the tree of the
+        /// same degree already there, and the result with the next, and
+        /// so on until its degree is free.
+        /// </summary>
+        /// <param name="table">Table the tree is added to.</param>
+        /// <param name="root">Root of the tree, taken off the root list.</param>
+        root->left = root;
+        root->right = root;
+
+        while (true) {
+            // Clear the slots up to the roots degree the first time a
+            // degree is reached.
+            while (table.top <= root->degree) { table.rank[table.top++] = nullptr; }
+
+            if (!table.rank[root->degree]) { break; }
+
+            // This rank has an element, so combine these trees. The
+            // tree with the lower priority root becomes the parent.
+            fhNode<T, Key> *other = table.rank[root->degree];
+            table.rank[root->degree] = nullptr;
+
+            if (less(other->priority, root->priority)) {
+                std::swap(other, root);
+            }
+
+            link(other, root);
+            ++table.links;
+        }
+
+        table.rank[root->degree] = root;
+    }
+
+    std::size_t count_roots(std::size_t limit) const {
+        /// <summary>
+        /// Returns the number of roots, counting no further than limit.
+        /// </summary>
+        std::size_t count = 0;
+        const fhNode<T, Key> *root = min_node;
+        do {
+            ++count;
+            root = root->right;
+        } while (root != min_node && count < limit);
+        return count;
+    }
+
+    std::uint64_t consolidate_parallel(rank_table &table) {
+        /// <summary>
+        /// Link the roots into table in parallel, each part of the root
+        /// list into a table of its own, then merge the tables pairwise.
+        /// The trees of different parts share no nodes, so the parts
+        /// never touch the same node.
+        /// </summary>
+        /// <param name="table">Empty table the roots end up in.</param>
+        /// <returns>Number of roots linked.</returns>
+
+        // Walk the root list once, marking every stride roots, so the
+        // parts can start at marks and hold about as many roots each.
+        std::size_t stride = size / (parallel->tasks * 64) + 1, count = 0;
+        std::vector<fhNode<T, Key>*> marks;
+        fhNode<T, Key> *root = min_node;
+        do {
+            if (count % stride == 0) { marks.push_back(root); }
+            ++count;
+            root = root->right;
+        } while (root != min_node);
+
+        // First root of every part, each part is the run of roots up to
+        // the next part's first root. Every task reads a root's right
+        // link before relinking the root, and only its own roots.
+        std::size_t tasks = std::min(parallel->tasks, marks.size());
+        std::vector<fhNode<T, Key>*> starts(tasks + 1);
+        for (std::size_t part = 0; part < tasks; ++part) { starts[part] = marks[marks.size() * part / tasks]; }
+        starts[tasks] = min_node;
+
+        std::vector<rank_table> tables(tasks);
+
+        // Each part is linked into a table of the task's own, which
+        // can't alias the nodes written, and copied out once done.
+        parallel->run(tasks, [&](std::size_t part) {
+            rank_table part_table;
+            fhNode<T, Key> *curr_root = starts[part], *next_root;
+            do {
+                next_root = curr_root->right;
+                rank_root(part_table, curr_root);
+                curr_root = next_root;
+            } while (curr_root != starts[part + 1]);
+            tables[part] = part_table;
+        });
+
+        // Round by round table i takes in table i + step, until table 0
+        // holds every tree.
+        for (std::size_t step = 1; step < tasks; step *= 2) {
+            parallel->run((tasks + step * 2 - 1) / (step * 2), [&](std::size_t pair) {
+                std::size_t into = pair * step * 2, from = into + step;
+                if (from >= tasks) { return; }
+
+                tables[into].links += tables[from].links;
+                for (unsigned degree = 0; degree < tables[from].top; ++degree) {
+                    if (tables[from].rank[degree]) { rank_root(tables[into], tables[from].rank[degree]); }
+                }
+            });
+        }
+
+        table = tables[0];
+        return count;
+    }
+
+    static void run_threads(std::size_t count, const std::function<void(std::size_t)> &job) {
+        /// <summary>
+        /// Default executor of parallel consolidation, runs job 0 on the
+        /// calling thread and every other job on a thread of its own, or
+        /// on the calling thread too if no thread can be started.
+        /// </summary>
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+
+        for (std::size_t i = 1; i < count; ++i) {
+            try {
+                threads.emplace_back(job, i);
+            }
+            catch (const std::system_error &) {
+                job(i);
+            }
+        }
+
+        job(0);
+        for (std::thread &thread : threads) { thread.join(); }
+    }
+
+    void unrank(fhNode<T, Key> *node) {
+        /// <summary>
+        /// Make a root pending again before it is removed or its degree
+        /// changes, if incremental consolidation ranked it.
+        /// </summary>
+        /// <param name="node">Root leaving the rank.</param>
+        if (!incremental || incremental->rank[node->degree] != node) { return; }
+
+        incremental->rank[node->degree] = nullptr;
+        --incremental->ranked;
+        incremental->pending = true;
+        ++incremental->added;
+    }
+
+    void consolidate_step(std::size_t added) {
+        /// <summary>
+        /// Link pending roots into the rank until the budget is spent or
+        /// no root is pending. Each pending root is linked with the ranked
+        /// roots of its degree until its degree is free, which takes at
+        /// most max_degree links, the walk resumes where the last step
+        /// stopped.
+        /// </summary>
+        /// <param name="added">Roots the operation added without
+        /// add_root, paid for on top of the budget and the roots counted
+        /// in added so the pending roots never pile up.</param>
+        consolidation_state &state = *incremental;
+        std::size_t budget = state.budget + added + state.added;
+        state.added = 0;
+        if (!min_node || !state.pending) { return; }
+
+        fhNode<T, Key> *curr_root = state.cursor ? state.cursor : min_node;
+        std::uint64_t roots = 0, links = 0, degree = 0;
+
+        // Ranked roots passed in a row, more than there are ranked
+        // roots means the walk went all the way around without finding
+        // a pending one.
+        unsigned passed = 0;
+
+        while (roots < budget) {
+            if (state.rank[curr_root->degree] == curr_root) {
+                if (++passed > state.ranked) {
+                    state.pending = false;
+                    break;
+                }
+                curr_root = curr_root->right;
+                continue;
+            }
+            passed = 0;
+            ++roots;
+
+            while (state.rank[curr_root->degree]) {
+                fhNode<T, Key> *other = state.rank[curr_root->degree];
+                state.rank[curr_root->degree] = nullptr;
+                --state.ranked;
+
+                if (less(other->priority, curr_root->priority)) {
+                    std::swap(other, curr_root);
+                }
+
+                // A root with the same priority as min_node may take its
+                // place, min_node has to stay a root.
+                if (other == min_node) { min_node = curr_root; }
+
+                other->unlink();
+                link(other, curr_root);
+                ++links;
+            }
+
+            state.rank[curr_root->degree] = curr_root;
+            ++state.ranked;
+            if (curr_root->degree > degree) { degree = curr_root->degree; }
+            curr_root = curr_root->right;
+        }
+
+        state.cursor = curr_root;
+        record_consolidation(roots, links, degree);
+    }
+
+    void merge_copy(FibonacciHeap<T, Key, Compare, Alloc> &other) {
+        /// <summary>
+        /// Combine with a collection whose allocator differs from this
+        /// one, by copying its nodes into this pool and clearing it.
+        /// </summary>
+        /// <param name="other">Collection being combined with the 
+        /// current collection.</param>
+        FibonacciHeap<T, Key, Compare, Alloc> other_copy(other, pool.get_allocator());
+        other.clear();
+        merge(std::move(other_copy));
+    }
+
+    void copy_from(const FibonacciHeap<T, Key, Compare, Alloc> &copy) {
+        /// <summary>
+        /// Fill an empty collection with a copy of every tree in another
+        /// collection. The copies are made in one pass over the forest,
+        /// without recursion, into a single block of adjacent nodes.
+        /// </summary>
+        /// <param name="copy">Collection being copied.</param>
+        if (copy.incremental) { set_consolidation_budget(copy.incremental->budget); }
+        if (copy.parallel) { parallel.reset(new parallel_settings(*copy.parallel)); }
+        if (!copy.min_node) { return; }
+
+        // Node being copied, and the copy of its parent (nullptr for
+        // the roots).
+        const fhNode<T, Key> *curr_node = copy.min_node;
+        fhNode<T, Key> *new_parent = nullptr, *new_node;
+
+        pool.reserve(copy.size);
+
+        while (curr_node) {
+            new_node = pool.allocate_reserved(curr_node->priority, curr_node->value);
+            new_node->marked = curr_node->marked;
+            new_node->degree = curr_node->degree;
+            new_node->parent = new_parent;
+
+            // Append the copy to its parent's child list, or to the root
+            // list, keeping the order of the original.
+            fhNode<T, Key> *&first = new_parent ? new_parent->child : min_node;
+            if (first) {
+                fhNode<T, Key>::splice(first->left, new_node);
+            }
+            else {
+                first = new_node;
+            }
+
+            // Copy the children of curr_node before its siblings.
+            if (curr_node->child) {
+                new_parent = new_node;
+                curr_node = curr_node->child;
+                continue;
+            }
+
+            // Otherwise move on to the next sibling, climbing up to the
+            // first ancestor that still has siblings left to copy.
+            while (curr_node) {
+                const fhNode<T, Key> *first_sibling = curr_node->parent ? curr_node->parent->child : copy.min_node;
+                if (curr_node->right != first_sibling) {
+                    curr_node = curr_node->right;
+                    break;
+                }
+
+                curr_node = curr_node->parent;
+                if (new_parent) { new_parent = new_parent->parent; }
+            }
+        }
+
+        size = copy.size;
     }
 };
@@ -0,0 +1,281 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: GraphAlgorithms
+    File: GraphAlgorithms.h
+
+    Dijkstra's shortest paths, Prim's minimum spanning forest and A*
+    search over a compressed sparse row graph, using a FibonacciHeap of
+    vertex ids. Every routine keeps a flat table from vertex id to the
+    handle of its node, so relaxing an edge is a single O(1)
+    decrease_key instead of a search of the heap.
+
+    Cost summary:
+    fhDijkstra         O(m + n log(n))
+    fhPrim             O(m + n log(n))
+    fhAstar            O(m + n log(n)), with a consistent heuristic
+    (n = number of vertices, m = number of edges)
+*/
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+
+template <typename Weight>
+class fhCsrGraph {
+/// <summary>
+/// Directed graph in compressed sparse row form, the edges leaving vertex
+/// v are targets[offsets[v]] to targets[offsets[v + 1] - 1], with their
+/// weights at the same positions.
+/// </summary>
+/// <typeparam name="Weight">Type of the edge weights.</typeparam>
+public:
+    struct edge {
+        std::uint32_t from;
+        std::uint32_t to;
+        Weight weight;
+    };
+
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<Weight> weights;
+
+    /*
+    Default constructor, the fhCsrGraph is initialized to a graph without
+    vertices.
+    */
+    fhCsrGraph() : offsets(1, 0) {}
+
+    /*
+    Edge list constructor, the fhCsrGraph is initialized to the vertices
+    0 to vertices - 1 and the edges given, keeping the order of the
+    edges leaving each vertex.
+
+    @parameter: vertices (uint32_t) - Number of vertices.
+    @parameter: edges (std::vector<edge>) - Edges of the graph, every
+                                            end is below vertices.
+    @parameter: undirected (bool) - If true, every edge is also added
+                                    in the other direction.
+    */
+    fhCsrGraph(std::uint32_t vertices, const std::vector<edge> &edges, bool undirected = false)
+        : offsets(static_cast<std::size_t>(vertices) + 1, 0) {
+        // Count the edges leaving every vertex, then turn the counts
+        // into the position each vertex's edges start at.
+        for (const edge &curr : edges) {
+            ++offsets[curr.from + 1];
+            if (undirected) { ++offsets[curr.to + 1]; }
+        }
+        for (std::uint32_t v = 0; v < vertices; ++v) { offsets[v + 1] += offsets[v]; }
+
+        targets.resize(offsets[vertices]);
+        weights.resize(offsets[vertices]);
+
+        std::vector<std::uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (const edge &curr : edges) {
+            std::uint32_t i = next[curr.from]++;
+            targets[i] = curr.to;
+            weights[i] = curr.weight;
+
+            if (undirected) {
+                i = next[curr.to]++;
+                targets[i] = curr.from;
+                weights[i] = curr.weight;
+            }
+        }
+    }
+
+    std::uint32_t get_vertex_count() const {
+        /// <summary>
+        /// Returns the number of vertices.
+        /// </summary>
+        return static_cast<std::uint32_t>(offsets.size() - 1);
+    }
+
+    std::size_t get_edge_count() const {
+        /// <summary>
+        /// Returns the number of directed edges.
+        /// </summary>
+        return targets.size();
+    }
+};
+
+
+template <typename Weight>
+struct fhShortestPaths {
+/// <summary>
+/// Result of fhDijkstra and fhAstar, the distance of every vertex from
+/// the source and its parent on a shortest path. Vertices never reached
+/// are at unreached and have no_vertex as parent.
+/// </summary>
+/// <typeparam name="Weight">Type of the edge weights.</typeparam>
+    static constexpr std::uint32_t no_vertex = ~std::uint32_t(0);
+    static constexpr Weight unreached = std::numeric_limits<Weight>::max();
+
+    std::vector<Weight> distance;
+    std::vector<std::uint32_t> parent;
+
+    explicit fhShortestPaths(std::uint32_t vertices) : distance(vertices, unreached), parent(vertices, no_vertex) {}
+};
+
+
+template <typename Weight>
+struct fhSpanningForest {
+/// <summary>
+/// Result of fhPrim, the parent of every vertex in a minimum spanning
+/// forest and the total weight of the forest. The root of every tree has
+/// no_vertex as parent.
+/// </summary>
+/// <typeparam name="Weight">Type of the edge weights.</typeparam>
+    static constexpr std::uint32_t no_vertex = ~std::uint32_t(0);
+
+    std::vector<std::uint32_t> parent;
+    Weight weight = Weight();
+
+    explicit fhSpanningForest(std::uint32_t vertices) : parent(vertices, no_vertex) {}
+};
+
+
+template <typename Weight, typename Heuristic>
+fhShortestPaths<Weight> fhSearchPaths(const fhCsrGraph<Weight> &graph, std::uint32_t source, std::uint32_t target,
+                                      Heuristic heuristic) {
+    /// <summary>
+    /// Best first search shared by fhDijkstra and fhAstar, vertices are
+    /// taken by distance plus heuristic, and the search stops when
+    /// target is taken. A vertex reached by a shorter path after it was
+    /// taken is searched again, so an admissible heuristic that is not
+    /// consistent still finds the shortest path.
+    /// </summary>
+    std::uint32_t vertices = graph.get_vertex_count();
+    fhShortestPaths<Weight> paths(vertices);
+    if (source >= vertices) { return paths; }
+
+    // Handle of every vertex in the heap, empty once it is taken.
+    FibonacciHeap<std::uint32_t, Weight> heap;
+    std::vector<fhHandle<std::uint32_t, Weight>> handles(vertices);
+
+    paths.distance[source] = Weight();
+    handles[source] = heap.insert(source, heuristic(source));
+
+    while (!heap.is_empty()) {
+        std::uint32_t v = heap.extract_min().first;
+        handles[v] = fhHandle<std::uint32_t, Weight>();
+        if (v == target) { break; }
+
+        Weight distance = paths.distance[v];
+        for (std::uint32_t i = graph.offsets[v]; i < graph.offsets[v + 1]; ++i) {
+            std::uint32_t w = graph.targets[i];
+            Weight relaxed = distance + graph.weights[i];
+            if (!(relaxed < paths.distance[w])) { continue; }
+
+            paths.distance[w] = relaxed;
+            paths.parent[w] = v;
+            if (handles[w]) {
+                heap.decrease_key(handles[w], relaxed + heuristic(w));
+            }
+            else {
+                handles[w] = heap.insert(w, relaxed + heuristic(w));
+            }
+        }
+    }
+    return paths;
+}
+
+
+template <typename Weight>
+fhShortestPaths<Weight> fhDijkstra(const fhCsrGraph<Weight> &graph, std::uint32_t source) {
+    /// <summary>
+    /// Shortest paths from source to every vertex, the weights are not
+    /// negative.
+    /// </summary>
+    /// <param name="graph">Graph searched.</param>
+    /// <param name="source">Vertex the paths start at.</param>
+    /// <returns>Distance and parent of every vertex.</returns>
+    return fhSearchPaths(graph, source, fhShortestPaths<Weight>::no_vertex,
+                           [](std::uint32_t) { return Weight(); });
+}
+
+
+template <typename Weight, typename Heuristic>
+fhShortestPaths<Weight> fhAstar(const fhCsrGraph<Weight> &graph, std::uint32_t source, std::uint32_t target,
+                                Heuristic heuristic) {
+    /// <summary>
+    /// Shortest path from source to target, searched towards target by a
+    /// heuristic. The weights are not negative.
+    /// </summary>
+    /// <param name="graph">Graph searched.</param>
+    /// <param name="source">Vertex the path starts at.</param>
+    /// <param name="target">Vertex the path ends at.</param>
+    /// <param name="heuristic">Callable taking a vertex and returning a
+    /// Weight no greater than its distance to target.</param>
+    /// <returns>Distance and parent of every vertex searched, the path
+    /// is found by following parents back from target.</returns>
+    return fhSearchPaths(graph, source, target, heuristic);
+}
+
+
+template <typename Weight>
+fhSpanningForest<Weight> fhPrim(const fhCsrGraph<Weight> &graph) {
+    /// <summary>
+    /// Minimum spanning forest of an undirected graph, every edge is
+    /// stored in both directions.
+    /// </summary>
+    /// <param name="graph">Graph spanned.</param>
+    /// <returns>Parent of every vertex and the weight of the forest.</returns>
+    std::uint32_t vertices = graph.get_vertex_count();
+    fhSpanningForest<Weight> forest(vertices);
+
+    // Lightest edge known from the forest to every vertex, whether the
+    // vertex joined, and the handle of every vertex in the heap.
+    FibonacciHeap<std::uint32_t, Weight> heap;
+    std::vector<Weight> lightest(vertices);
+    std::vector<bool> joined(vertices, false);
+    std::vector<fhHandle<std::uint32_t, Weight>> handles(vertices);
+
+    // Grow a tree from every vertex no earlier tree reached.
+    for (std::uint32_t root = 0; root < vertices; ++root) {
+        if (joined[root]) { continue; }
+
+        lightest[root] = Weight();
+        handles[root] = heap.insert(root, Weight());
+
+        while (!heap.is_empty()) {
+            std::pair<std::uint32_t, Weight> min = heap.extract_min();
+            std::uint32_t v = min.first;
+            handles[v] = fhHandle<std::uint32_t, Weight>();
+            joined[v] = true;
+            forest.weight += min.second;
+
+            for (std::uint32_t i = graph.offsets[v]; i < graph.offsets[v + 1]; ++i) {
+                std::uint32_t w = graph.targets[i];
+                if (joined[w]) { continue; }
+
+                const Weight &weight = graph.weights[i];
+                if (handles[w]) {
+                    if (!(weight < lightest[w])) { continue; }
+                    heap.decrease_key(handles[w], weight);
+                }
+                else {
+                    handles[w] = heap.insert(w, weight);
+                }
+                lightest[w] = weight;
+                forest.parent[w] = v;
+            }
+        }
+    }
+    return forest;
+}
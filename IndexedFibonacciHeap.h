@@ -0,0 +1,535 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: IndexedFibonacciHeap
+    File: IndexedFibonacciHeap.h
+
+    A FibonacciHeap of unique values, that keeps an open addressing
+    hash table from every value to its node. Callers that only know a
+    value can change its priority, erase it or check for it in O(1)
+    expected time, without the old priority and without searching the
+    trees the way FibonacciHeap::find does.
+
+    Cost summary, on top of FibonacciHeap's:
+    insert                  O(1) expected
+    contains                O(1) expected
+    change_priority(value)  O(1) expected, O(log(n)) if raised
+    erase(value)            O(log(n))
+    merge                   O(m) expected, m nodes merged
+*/
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+
+template <typename T, typename Key, typename Hash, typename KeyEqual, typename Alloc>
+class fhValueIndex {
+/// <summary>
+/// Open addressing hash table from values to the handles of the nodes
+/// holding them, probed linearly. Removals shift the entries after them
+/// back, so there are no tombstones and lookups never slow down.
+/// </summary>
+/// <typeparam name="T">Values indexed, every value is unique.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="Hash">Hash of the values.</typeparam>
+/// <typeparam name="KeyEqual">Equality of the values.</typeparam>
+/// <typeparam name="Alloc">Allocator the table is allocated with.</typeparam>
+public:
+    typedef fhHandle<T, Key> handle;
+
+private:
+    // Handle to a node and the hash of its value, an empty bucket has
+    // a null handle.
+    struct bucket {
+        handle node;
+        std::size_t hash;
+    };
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<bucket> bucket_allocator;
+
+    std::vector<bucket, bucket_allocator> buckets;
+    std::size_t count = 0;
+
+    // Home bucket of a hash is its top bits after multiplying by
+    // 2^64 / phi, which spreads out hashes that differ in few bits.
+    unsigned shift = 64;
+
+    Hash hasher;
+    KeyEqual equal;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+    explicit fhValueIndex(const Hash &hasher = Hash(), const KeyEqual &equal = KeyEqual(), const Alloc &alloc = Alloc())
+        : buckets(bucket_allocator(alloc)), hasher(hasher), equal(equal) {}
+
+    std::size_t hash(const T &value) const {
+        /// <summary>
+        /// Returns the hash of a value.
+        /// </summary>
+        return hasher(value);
+    }
+
+    template <typename Heap>
+    handle find(const Heap &heap, const T &value, std::size_t value_hash) const {
+        /// <summary>
+        /// Returns the handle of the node holding value, or a null handle.
+        /// </summary>
+        /// <param name="heap">Heap the nodes are in.</param>
+        /// <param name="value">Value searched for.</param>
+        /// <param name="value_hash">Hash of the value.</param>
+        std::size_t i = position(heap, value, value_hash);
+        return i == npos ? handle() : buckets[i].node;
+    }
+
+    void insert(handle node, std::size_t value_hash) {
+        /// <summary>
+        /// Add the node of a value that is not in the table yet.
+        /// </summary>
+        /// <param name="node">Handle to the node.</param>
+        /// <param name="value_hash">Hash of the node's value.</param>
+
+        // Grow at three quarters full, linear probing degrades quickly
+        // past that.
+        if ((count + 1) * 4 > buckets.size() * 3) { rehash(buckets.empty() ? 16 : buckets.size() * 2); }
+
+        std::size_t mask = buckets.size() - 1;
+        std::size_t i = home(value_hash);
+        while (buckets[i].node) { i = (i + 1) & mask; }
+
+        buckets[i].node = node;
+        buckets[i].hash = value_hash;
+        ++count;
+    }
+
+    template <typename Heap>
+    bool erase(const Heap &heap, const T &value, std::size_t value_hash) {
+        /// <summary>
+        /// Remove a value from the table, shifting back the entries that
+        /// probed past it. Returns false if it was not there.
+        /// </summary>
+        /// <param name="heap">Heap the nodes are in.</param>
+        /// <param name="value">Value being removed.</param>
+        /// <param name="value_hash">Hash of the value.</param>
+        /// <returns>True if the value was removed;
+        /// otherwise false.</returns>
+        std::size_t i = position(heap, value, value_hash);
+        if (i == npos) { return false; }
+
+        std::size_t mask = buckets.size() - 1;
+        std::size_t j = i;
+        while (true) {
+            j = (j + 1) & mask;
+            if (!buckets[j].node) { break; }
+
+            // The entry at j can fill the hole at i unless its home
+            // bucket lies cyclically in (i, j].
+            std::size_t k = home(buckets[j].hash);
+            bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (stays) { continue; }
+
+            buckets[i] = buckets[j];
+            i = j;
+        }
+
+        buckets[i].node = handle();
+        --count;
+        return true;
+    }
+
+    template <typename Visit>
+    void for_each(Visit visit) const {
+        /// <summary>
+        /// Call visit with the handle and hash of every entry.
+        /// </summary>
+        for (const bucket &curr : buckets) {
+            if (curr.node) { visit(curr.node, curr.hash); }
+        }
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every entry, keeping the memory of the table.
+        /// </summary>
+        for (bucket &curr : buckets) { curr.node = handle(); }
+        count = 0;
+    }
+
+    void reserve(std::size_t entries) {
+        /// <summary>
+        /// Grow the table so entries values fit without rehashing.
+        /// </summary>
+        std::size_t capacity = buckets.empty() ? 16 : buckets.size();
+        while (entries * 4 > capacity * 3) { capacity *= 2; }
+        if (capacity != buckets.size()) { rehash(capacity); }
+    }
+
+    void swap(fhValueIndex &other) {
+        /// <summary>
+        /// Exchange the contents of two tables.
+        /// </summary>
+        buckets.swap(other.buckets);
+        std::swap(count, other.count);
+        std::swap(shift, other.shift);
+        std::swap(hasher, other.hasher);
+        std::swap(equal, other.equal);
+    }
+
+private:
+    std::size_t home(std::size_t value_hash) const {
+        /// <summary>
+        /// Returns the bucket a hash is probed from.
+        /// </summary>
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(value_hash) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    template <typename Heap>
+    std::size_t position(const Heap &heap, const T &value, std::size_t value_hash) const {
+        /// <summary>
+        /// Returns the bucket holding value, or npos.
+        /// </summary>
+        if (!count) { return npos; }
+
+        std::size_t mask = buckets.size() - 1;
+        for (std::size_t i = home(value_hash); buckets[i].node; i = (i + 1) & mask) {
+            if (buckets[i].hash == value_hash && equal(heap.get_value(buckets[i].node), value)) { return i; }
+        }
+        return npos;
+    }
+
+    void rehash(std::size_t capacity) {
+        /// <summary>
+        /// Move every entry into a table of capacity buckets, a power of
+        /// two. The stored hashes are reused, values are not hashed again.
+        /// </summary>
+        std::vector<bucket, bucket_allocator> old(capacity, bucket{ handle(), 0 }, buckets.get_allocator());
+        old.swap(buckets);
+
+        shift = 64;
+        for (std::size_t size = capacity; size > 1; size >>= 1) { --shift; }
+
+        std::size_t mask = capacity - 1;
+        for (const bucket &curr : old) {
+            if (!curr.node) { continue; }
+
+            std::size_t i = home(curr.hash);
+            while (buckets[i].node) { i = (i + 1) & mask; }
+            buckets[i] = curr;
+        }
+    }
+};
+
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>,
+          typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class IndexedFibonacciHeap {
+/// <summary>
+/// FibonacciHeap whose values are unique and can be looked up in O(1)
+/// expected time. Every operation that adds or removes a node updates
+/// the index.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection,
+/// every value is contained at most once.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes and the
+/// index.</typeparam>
+/// <typeparam name="Hash">Hash of the values.</typeparam>
+/// <typeparam name="KeyEqual">Equality of the values.</typeparam>
+private:
+    typedef FibonacciHeap<T, Key, Compare, Alloc> heap_type;
+
+    heap_type heap;
+    fhValueIndex<T, Key, Hash, KeyEqual, Alloc> index;
+
+public:
+    // Handle to a Node in the collection, returned by insert.
+    typedef fhHandle<T, Key> handle;
+
+    /*
+    Default constructor, the IndexedFibonacciHeap is initialized to an
+    empty collection.
+    */
+    IndexedFibonacciHeap() {}
+
+    /*
+    Compare constructor, the IndexedFibonacciHeap is initialized to an
+    empty collection ordered by comp.
+
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes and the
+                                index.
+    @parameter: hasher (Hash) - Hash of the values.
+    @parameter: equal (KeyEqual) - Equality of the values.
+    */
+    explicit IndexedFibonacciHeap(const Compare &comp, const Alloc &alloc = Alloc(),
+                                  const Hash &hasher = Hash(), const KeyEqual &equal = KeyEqual())
+        : heap(comp, alloc), index(hasher, equal, alloc) {}
+
+    IndexedFibonacciHeap(const IndexedFibonacciHeap&) = delete;
+    IndexedFibonacciHeap& operator=(const IndexedFibonacciHeap&) = delete;
+
+    IndexedFibonacciHeap(IndexedFibonacciHeap&&) = default;
+    IndexedFibonacciHeap& operator=(IndexedFibonacciHeap&&) = default;
+
+    void swap(IndexedFibonacciHeap &other) {
+        /// <summary>
+        /// Exchange the contents of two collections, handles keep
+        /// referring to the same nodes.
+        /// </summary>
+        /// <param name="other">Collection being exchanged with.</param>
+        heap.swap(other.heap);
+        index.swap(other.index);
+    }
+
+    std::pair<handle, bool> insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node, unless the value is already in the
+        /// collection.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the node holding value, and true if it was
+        /// inserted; false if the value was already there.</returns>
+        std::size_t value_hash = index.hash(value);
+        handle node = index.find(heap, value, value_hash);
+        if (node) { return std::pair<handle, bool>(node, false); }
+
+        node = heap.insert(value, priority);
+        index.insert(node, value_hash);
+        return std::pair<handle, bool>(node, true);
+    }
+
+    std::pair<handle, bool> insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node moving value into it, unless the value is
+        /// already in the collection.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the node holding value, and true if it was
+        /// inserted; false if the value was already there.</returns>
+        std::size_t value_hash = index.hash(value);
+        handle node = index.find(heap, value, value_hash);
+        if (node) { return std::pair<handle, bool>(node, false); }
+
+        node = heap.insert(std::move(value), priority);
+        index.insert(node, value_hash);
+        return std::pair<handle, bool>(node, true);
+    }
+
+    bool contains(const T &value) const {
+        /// <summary>
+        /// Returns true if a node holds value; otherwise false.
+        /// </summary>
+        /// <param name="value">Value searched for.</param>
+        return static_cast<bool>(index.find(heap, value, index.hash(value)));
+    }
+
+    handle find(const T &value) const {
+        /// <summary>
+        /// Returns the handle of the node holding value, or a null
+        /// handle if there is none.
+        /// </summary>
+        /// <param name="value">Value searched for.</param>
+        return index.find(heap, value, index.hash(value));
+    }
+
+    bool change_priority(const T &value, const Key &new_priority) {
+        /// <summary>
+        /// Change the priority of the node holding value.
+        /// </summary>
+        /// <param name="value">Value contained by the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        /// <returns>True if the value was found;
+        /// otherwise false.</returns>
+        handle node = find(value);
+        if (!node) { return false; }
+
+        heap.change_priority(node, new_priority);
+        return true;
+    }
+
+    void change_priority(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Change the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        heap.change_priority(node, new_priority);
+    }
+
+    bool erase(const T &value) {
+        /// <summary>
+        /// Remove the node holding value.
+        /// </summary>
+        /// <param name="value">Value contained by the target node.</param>
+        /// <returns>True if the value was found;
+        /// otherwise false.</returns>
+        std::size_t value_hash = index.hash(value);
+        handle node = index.find(heap, value, value_hash);
+        if (!node) { return false; }
+
+        index.erase(heap, value, value_hash);
+        heap.erase(node);
+        return true;
+    }
+
+    void erase(const handle &node) {
+        /// <summary>
+        /// Remove the node referred to by a handle. The handle is no
+        /// longer valid after this call.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        if (!node) { return; }
+
+        const T &value = heap.get_value(node);
+        index.erase(heap, value, index.hash(value));
+        heap.erase(node);
+    }
+
+    void delete_min() {
+        /// <summary>
+        /// Remove the minimum node.
+        /// </summary>
+        const fhNode<T, Key> *min = heap.find_min();
+        if (!min) { return; }
+
+        index.erase(heap, min->value, index.hash(min->value));
+        heap.delete_min();
+    }
+
+    std::pair<T, Key> extract_min() {
+        /// <summary>
+        /// Return the value and priority of the minimum node, and remove
+        /// it. Throws std::out_of_range if the collection is empty.
+        /// </summary>
+        /// <returns>Value and priority of the minimum node.</returns>
+        const fhNode<T, Key> *min = heap.find_min();
+        if (!min) { throw std::out_of_range("extract_min called on an empty IndexedFibonacciHeap"); }
+
+        index.erase(heap, min->value, index.hash(min->value));
+        return heap.extract_min();
+    }
+
+    bool extract_min(T &value) {
+        /// <summary>
+        /// Move the value of the minimum node into value, and remove it.
+        /// </summary>
+        /// <param name="value">Object the minimum value is moved
+        /// into.</param>
+        /// <returns>True if a value was extracted; false if the
+        /// collection was empty.</returns>
+        const fhNode<T, Key> *min = heap.find_min();
+        if (!min) { return false; }
+
+        index.erase(heap, min->value, index.hash(min->value));
+        return heap.extract_min(value);
+    }
+
+    const fhNode<T, Key>* find_min() const {
+        /// <summary>
+        /// Return the minimum node, without removing it. The node can't
+        /// be changed, a changed value would no longer be found by the
+        /// index, use change_priority to change its priority.
+        /// </summary>
+        return heap.find_min();
+    }
+
+    const T& get_value(const handle &node) const {
+        /// <summary>
+        /// Returns the value contained by the node referred to by a handle.
+        /// </summary>
+        return heap.get_value(node);
+    }
+
+    Key get_priority(const handle &node) const {
+        /// <summary>
+        /// Returns the priority of the node referred to by a handle.
+        /// </summary>
+        return heap.get_priority(node);
+    }
+
+    void merge(IndexedFibonacciHeap &&other) {
+        /// <summary>
+        /// Move every node of the other collection into this one, leaving
+        /// it empty. A value held by both collections keeps the lower of
+        /// its two priorities, and the other collection's node for it is
+        /// removed.
+        /// </summary>
+        /// <param name="other">Collection being combined with the
+        /// current collection.</param>
+        if (&other == this || other.is_empty()) { return; }
+
+        // Resolve the values held by both first, other's table can't
+        // change while it is walked.
+        std::vector<handle> shared;
+        Compare comp = heap.get_compare();
+        other.index.for_each([&](handle node, std::size_t value_hash) {
+            handle mine = index.find(heap, other.heap.get_value(node), value_hash);
+            if (!mine) { return; }
+
+            if (comp(other.heap.get_priority(node), heap.get_priority(mine))) {
+                heap.change_priority(mine, other.heap.get_priority(node));
+            }
+            shared.push_back(node);
+        });
+        for (const handle &node : shared) { other.erase(node); }
+
+        // Handles only move with the nodes when the allocators are
+        // equal, otherwise the nodes are inserted one by one.
+        if (!(heap.get_allocator() == other.heap.get_allocator())) {
+            while (!other.is_empty()) {
+                std::pair<T, Key> min = other.heap.extract_min();
+                insert(std::move(min.first), min.second);
+            }
+            other.index.clear();
+            return;
+        }
+
+        index.reserve(get_size() + other.get_size());
+        other.index.for_each([&](handle node, std::size_t value_hash) { index.insert(node, value_hash); });
+        other.index.clear();
+        heap.merge(std::move(other.heap));
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node from the collection.
+        /// </summary>
+        index.clear();
+        heap.clear();
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the collection.
+        /// </summary>
+        return heap.get_size();
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false.
+        /// </summary>
+        return get_size() == 0;
+    }
+};
@@ -0,0 +1,257 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: MultiQueueFibonacciHeap
+    File: MultiQueueFibonacciHeap.h
+
+    A relaxed priority queue over c * p independent FibonacciHeaps,
+    where p is the number of threads using it and c the relaxation
+    factor. Inserts go to a random heap, extracts remove the better
+    minimum of two random heaps. Extracted nodes are close to the
+    minimum rather than exactly the minimum, the more heaps there are
+    the further off they may be, and the less the threads contend.
+
+    Based on the MultiQueue of Rihani, Sanders and Dementiev, 2015.
+*/
+#pragma once
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "FibonacciHeap.h"
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>>
+class MultiQueueFibonacciHeap {
+/// <summary>
+/// Relaxed concurrent priority queue, safe to use from any number of
+/// threads. Every heap has its own lock, which is only ever tried, a
+/// thread that finds it taken picks other heaps instead of waiting.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes.</typeparam>
+private:
+    typedef FibonacciHeap<T, Key, Compare, Alloc> heap_type;
+
+    // One heap and its lock, on a cache line of its own so threads
+    // using neighbouring heaps don't slow each other down.
+    struct alignas(64) queue {
+        std::mutex lock;
+        heap_type heap;
+
+        queue(const Compare &comp, const Alloc &alloc) : heap(comp, alloc) {}
+    };
+
+    // A deque constructs each queue in place, and never moves them.
+    std::deque<queue> queues;
+    std::size_t queue_count;
+    std::size_t relaxation;
+    Compare comp;
+
+    std::atomic<std::size_t> size{ 0 };
+
+public:
+    /*
+    Default constructor, the MultiQueueFibonacciHeap is initialized to
+    two heaps per hardware thread.
+    */
+    MultiQueueFibonacciHeap() : MultiQueueFibonacciHeap(0) {}
+
+    /*
+    Thread count constructor, the MultiQueueFibonacciHeap is
+    initialized to relaxation heaps per thread.
+
+    @parameter: threads (size_t) - Number of threads using the
+                                   collection, the number of hardware
+                                   threads if 0.
+    @parameter: relaxation (size_t) - Number of heaps per thread,
+                                      higher values contend less and
+                                      extract further from the
+                                      minimum.
+    @parameter: comp (Compare) - Ordering of the priorities.
+    @parameter: alloc (Alloc) - Allocator used for the nodes.
+    */
+    explicit MultiQueueFibonacciHeap(std::size_t threads, std::size_t relaxation = 2,
+                                     const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+        : relaxation(relaxation ? relaxation : 1), comp(comp) {
+        if (!threads) { threads = std::thread::hardware_concurrency(); }
+        if (!threads) { threads = 1; }
+
+        queue_count = threads * this->relaxation;
+        for (std::size_t i = 0; i < queue_count; ++i) { queues.emplace_back(comp, alloc); }
+    }
+
+    MultiQueueFibonacciHeap(const MultiQueueFibonacciHeap&) = delete;
+    MultiQueueFibonacciHeap& operator=(const MultiQueueFibonacciHeap&) = delete;
+
+    void insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into a random heap.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        emplace(priority, value);
+    }
+
+    void insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into a random heap, moving value into the
+        /// node.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        emplace(priority, std::move(value));
+    }
+
+    template <typename... Args>
+    void emplace(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Insert a new Node into a random heap, the value is constructed
+        /// in place inside the node.
+        /// </summary>
+        /// <param name="priority">Priority key value.</param>
+        /// <param name="args">Arguments the generic object contained by
+        /// the node is constructed from.</param>
+        queue *curr;
+        do {
+            curr = &queues[random_index()];
+        } while (!curr->lock.try_lock());
+
+        std::lock_guard<std::mutex> guard(curr->lock, std::adopt_lock);
+        curr->heap.emplace(priority, std::forward<Args>(args)...);
+
+        // Counted before the lock is released, so the node is never
+        // extracted before it is counted.
+        size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool extract_min(T &value) {
+        /// <summary>
+        /// Move the value of a node close to the minimum out of the
+        /// collection, and remove the node. Returns false if the
+        /// collection was empty.
+        /// </summary>
+        /// <param name="value">Object the node's value is moved
+        /// into.</param>
+        /// <returns>True if a node was removed;
+        /// otherwise false.</returns>
+        Key priority;
+        return extract_min(value, priority);
+    }
+
+    bool extract_min(T &value, Key &priority) {
+        /// <summary>
+        /// Move the value and priority of a node close to the minimum out
+        /// of the collection, and remove the node. Returns false if the
+        /// collection was empty.
+        /// </summary>
+        /// <param name="value">Object the node's value is moved
+        /// into.</param>
+        /// <param name="priority">Key the node's priority is copied
+        /// into.</param>
+        /// <returns>True if a node was removed;
+        /// otherwise false.</returns>
+        while (size.load(std::memory_order_relaxed)) {
+            queue *first = &queues[random_index()];
+            queue *second = &queues[random_index()];
+
+            if (!first->lock.try_lock()) { continue; }
+            std::lock_guard<std::mutex> first_guard(first->lock, std::adopt_lock);
+
+            // Both heaps are needed to compare their minimums, if the
+            // second is taken try two others.
+            std::unique_lock<std::mutex> second_guard;
+            if (second != first) {
+                second_guard = std::unique_lock<std::mutex>(second->lock, std::try_to_lock);
+                if (!second_guard) { continue; }
+            }
+
+            fhNode<T, Key> *first_min = first->heap.find_min();
+            fhNode<T, Key> *second_min = second->heap.find_min();
+
+            queue *best = first;
+            if (!first_min || (second_min && comp(second_min->priority, first_min->priority))) {
+                best = second;
+            }
+
+            // Both heaps are empty, but a node is somewhere else.
+            if (best->heap.is_empty()) { continue; }
+
+            std::pair<T, Key> min = best->heap.extract_min();
+            value = std::move(min.first);
+            priority = std::move(min.second);
+            size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node from the collection, one heap at a time.
+        /// </summary>
+        for (std::size_t i = 0; i < queue_count; ++i) {
+            std::lock_guard<std::mutex> guard(queues[i].lock);
+            size.fetch_sub(queues[i].heap.get_size(), std::memory_order_relaxed);
+            queues[i].heap.clear();
+        }
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the collection,
+        /// which may be out of date by the time it is read when other
+        /// threads are using the collection.
+        /// </summary>
+        return size.load(std::memory_order_relaxed);
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false. Out of date as soon as another thread inserts
+        /// or extracts.
+        /// </summary>
+        return get_size() == 0;
+    }
+
+    std::size_t get_queue_count() const {
+        /// <summary>
+        /// Returns the number of heaps the nodes are spread over.
+        /// </summary>
+        return queue_count;
+    }
+
+    std::size_t get_relaxation() const {
+        /// <summary>
+        /// Returns the number of heaps per thread.
+        /// </summary>
+        return relaxation;
+    }
+
+private:
+    std::size_t random_index() const {
+        /// <summary>
+        /// Returns the index of a random heap, every thread draws from
+        /// an engine of its own.
+        /// </summary>
+        thread_local std::minstd_rand engine(std::random_device{}());
+        return std::uniform_int_distribution<std::size_t>(0, queue_count - 1)(engine);
+    }
+};
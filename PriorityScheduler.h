@@ -0,0 +1,243 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: PriorityScheduler
+    File: PriorityScheduler.h
+
+    A pool of worker threads running tasks in priority order, lowest
+    priority first, out of a FibonacciHeap ready queue. Workers take
+    a batch of tasks with one extract_k and run them without touching
+    the heap again, so the lock is held once per batch.
+
+    Waiting tasks age without their keys ever being rewritten: every
+    task is keyed by its priority plus a global offset, which grows by
+    the aging step for every task dispatched. A task that waited for d
+    dispatches therefore runs as if its priority was d aging steps
+    lower than a task submitted now.
+
+    Idle workers spin, then park. Parking waits on an atomic with
+    std::atomic::wait when the standard library has it (C++20), and
+    otherwise sleeps with exponential backoff up to max_park_time, no
+    condition variable is ever used.
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+
+template <typename Key = long long>
+class PriorityScheduler {
+/// <summary>
+/// Worker thread pool running submitted tasks in priority order, with
+/// lazy aging so low priority tasks are never starved. Tasks must not
+/// throw.
+/// </summary>
+/// <typeparam name="Key">Type of the priorities, an arithmetic type the
+/// aging offset can be added to.</typeparam>
+public:
+    typedef std::function<void()> task;
+
+private:
+    typedef std::pair<task, Key> entry;
+
+    // Ready queue, and the offset added to the priorities submitted.
+    std::mutex heap_lock;
+    FibonacciHeap<task, Key> heap;
+    Key offset = Key();
+    Key aging_step;
+
+    // Most tasks a worker takes at once, and the number of workers
+    // sharing what is queued.
+    std::size_t batch_size;
+    std::size_t worker_count;
+
+    // Tasks submitted but not finished, and bumped on every submit so
+    // parked workers see there is work.
+    std::atomic<std::size_t> unfinished{ 0 };
+    std::atomic<std::uint32_t> epoch{ 0 };
+    std::atomic<bool> stopping{ false };
+
+    std::vector<std::thread> workers;
+
+    // Longest sleep of a parked worker without std::atomic::wait.
+    static constexpr std::chrono::microseconds max_park_time{ 1000 };
+
+public:
+    /*
+    Worker count constructor, the PriorityScheduler starts workers
+    threads that run tasks until it is destroyed.
+
+    @parameter: workers (size_t) - Number of worker threads, the number
+                                   of hardware threads if 0.
+    @parameter: aging_step (Key) - Priority a waiting task gains for
+                                   every task dispatched, 0 for no
+                                   aging.
+    @parameter: batch_size (size_t) - Most tasks a worker takes from the
+                                      heap at once, larger batches
+                                      lock less and follow priorities
+                                      less closely.
+    */
+    explicit PriorityScheduler(std::size_t workers = 0, const Key &aging_step = Key(), std::size_t batch_size = 8)
+        : aging_step(aging_step), batch_size(batch_size ? batch_size : 1), worker_count(workers) {
+        if (!worker_count) { worker_count = std::thread::hardware_concurrency(); }
+        if (!worker_count) { worker_count = 1; }
+
+        // Workers read worker_count, it is set before any starts.
+        this->workers.reserve(worker_count);
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            this->workers.emplace_back([this] { work(); });
+        }
+    }
+
+    PriorityScheduler(const PriorityScheduler&) = delete;
+    PriorityScheduler& operator=(const PriorityScheduler&) = delete;
+
+    /*
+    Destructor, runs every task still queued and then stops the
+    workers.
+    */
+    ~PriorityScheduler() {
+        stopping.store(true, std::memory_order_release);
+        wake(true);
+        for (std::thread &worker : workers) { worker.join(); }
+    }
+
+    void submit(task job, const Key &priority) {
+        /// <summary>
+        /// Queue a task, tasks with lower priorities run first.
+        /// </summary>
+        /// <param name="job">Task being queued.</param>
+        /// <param name="priority">Priority of the task.</param>
+        unfinished.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> guard(heap_lock);
+            heap.insert(std::move(job), priority + offset);
+        }
+        wake(false);
+    }
+
+    void wait_idle() {
+        /// <summary>
+        /// Block until every task submitted so far has finished, by
+        /// spinning and then sleeping with backoff.
+        /// </summary>
+        std::chrono::microseconds sleep(1);
+        for (unsigned spins = 0; unfinished.load(std::memory_order_acquire); ++spins) {
+            if (spins < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::this_thread::sleep_for(sleep);
+            if (sleep < max_park_time) { sleep *= 2; }
+        }
+    }
+
+    std::size_t get_unfinished() const {
+        /// <summary>
+        /// Returns the number of tasks queued or running.
+        /// </summary>
+        return unfinished.load(std::memory_order_relaxed);
+    }
+
+    std::size_t get_worker_count() const {
+        /// <summary>
+        /// Returns the number of worker threads.
+        /// </summary>
+        return worker_count;
+    }
+
+private:
+    void work() {
+        /// <summary>
+        /// Worker loop, take a batch of the lowest priority tasks and run
+        /// them in order, parking while there is nothing to take.
+        /// </summary>
+        std::vector<entry> batch;
+        batch.reserve(batch_size);
+
+        while (true) {
+            // Read before the heap is checked, so a task submitted after
+            // the check changes it and the worker doesn't park.
+            std::uint32_t seen = epoch.load(std::memory_order_acquire);
+            bool stop = stopping.load(std::memory_order_acquire);
+
+            {
+                std::lock_guard<std::mutex> guard(heap_lock);
+
+                // Split what is queued between the workers, so one
+                // batch doesn't hold every urgent task.
+                std::size_t queued = heap.get_size();
+                std::size_t share = queued / worker_count;
+                std::size_t take = share < 1 ? 1 : (share < batch_size ? share : batch_size);
+
+                heap.extract_k(take, std::back_inserter(batch));
+                offset += aging_step * static_cast<Key>(batch.size());
+            }
+
+            if (batch.empty()) {
+                if (stop) { return; }
+                park(seen);
+                continue;
+            }
+
+            for (entry &curr : batch) {
+                curr.first();
+                unfinished.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            batch.clear();
+        }
+    }
+
+    void wake(bool all) {
+        /// <summary>
+        /// Tell parked workers there is work, or that they should stop.
+        /// </summary>
+        epoch.fetch_add(1, std::memory_order_release);
+#if defined(__cpp_lib_atomic_wait)
+        if (all) { epoch.notify_all(); }
+        else { epoch.notify_one(); }
+#else
+        (void)all;
+#endif
+    }
+
+    void park(std::uint32_t seen) {
+        /// <summary>
+        /// Wait until epoch changes from seen, spinning briefly first.
+        /// </summary>
+        for (unsigned spins = 0; spins < 64; ++spins) {
+            if (epoch.load(std::memory_order_acquire) != seen) { return; }
+            std::this_thread::yield();
+        }
+
+#if defined(__cpp_lib_atomic_wait)
+        epoch.wait(seen, std::memory_order_acquire);
+#else
+        std::chrono::microseconds sleep(1);
+        while (epoch.load(std::memory_order_acquire) == seen) {
+            std::this_thread::sleep_for(sleep);
+            if (sleep < max_park_time) { sleep *= 2; }
+        }
+#endif
+    }
+};
@@ -0,0 +1,288 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: SnapshotFibonacciHeap
+    File: SnapshotFibonacciHeap.h
+
+    A FibonacciHeap with copy-on-write snapshots. Taking a snapshot
+    is O(1), the heap and its snapshots share one forest until one of
+    them is changed, at which point the forest is cloned once.
+
+    Because every node links to its parent and its siblings, changing
+    one node can't be done by copying only the path above it, which
+    is why the whole forest is cloned on the first change instead.
+*/
+#pragma once
+#include "FibonacciHeap.h"
+
+template <typename T, typename Key = long long, typename Compare = std::less<Key>, typename Alloc = std::allocator<T>>
+class SnapshotFibonacciHeap {
+/// <summary>
+/// FibonacciHeap whose copies are O(1) snapshots. A snapshot shares the
+/// forest of the collection it was taken from until either of them is
+/// changed. The collection that inserted the nodes keeps them, so its
+/// handles stay valid, and whoever else shares the forest gets a clone.
+/// Not safe to use from more than one thread at a time.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="Compare">Ordering of the priorities.</typeparam>
+/// <typeparam name="Alloc">Allocator used for the nodes.</typeparam>
+private:
+    typedef FibonacciHeap<T, Key, Compare, Alloc> heap_type;
+
+    // Forest shared by this collection and its snapshots.
+    std::shared_ptr<heap_type> heap;
+
+    // If the handles returned by this collection refer to nodes in
+    // heap, snapshots never have handles until they are changed.
+    bool owner = true;
+
+public:
+    // Handle to a Node in the collection, returned by insert.
+    typedef typename heap_type::handle handle;
+
+    /*
+    Default constructor, the SnapshotFibonacciHeap is initialized to
+    an empty collection.
+    */
+    SnapshotFibonacciHeap() : heap(std::make_shared<heap_type>()) {}
+
+    /*
+    Heap constructor, the SnapshotFibonacciHeap takes every node of
+    the parameter, handles to the nodes stay valid.
+
+    @parameter: other (FibonacciHeap) - Fibonacci Heap being moved
+                                        from.
+    */
+    explicit SnapshotFibonacciHeap(heap_type &&other)
+        : heap(std::make_shared<heap_type>(std::move(other))) {}
+
+    /*
+    Copy constructor, the SnapshotFibonacciHeap is initialized to a
+    snapshot of the parameter in O(1).
+
+    @parameter: copy (SnapshotFibonacciHeap) - Collection being
+                                               snapshotted.
+    */
+    SnapshotFibonacciHeap(const SnapshotFibonacciHeap &copy) : heap(copy.heap), owner(false) {}
+
+    /*
+    Move constructor, the SnapshotFibonacciHeap takes the forest of
+    the parameter, and its handles.
+
+    @parameter: other (SnapshotFibonacciHeap) - Collection being
+                                                moved from.
+    */
+    SnapshotFibonacciHeap(SnapshotFibonacciHeap &&other)
+        : heap(std::move(other.heap)), owner(other.owner) {
+        other.heap = std::make_shared<heap_type>();
+        other.owner = true;
+    }
+
+    SnapshotFibonacciHeap& operator=(SnapshotFibonacciHeap copy) {
+        /// <summary>
+        /// Replace the contents of this collection with a snapshot of, or
+        /// the forest moved from, another collection.
+        /// </summary>
+        /// <param name="copy">Collection being copied, or moved
+        /// from.</param>
+        std::swap(heap, copy.heap);
+        std::swap(owner, copy.owner);
+        return *this;
+    }
+
+    SnapshotFibonacciHeap snapshot() const {
+        /// <summary>
+        /// Returns a snapshot of this collection in O(1).
+        /// </summary>
+        /// <returns>Collection sharing this collection's forest.</returns>
+        return SnapshotFibonacciHeap(*this);
+    }
+
+    bool is_shared() const {
+        /// <summary>
+        /// Returns true if the forest is shared with a snapshot, so the
+        /// next change will clone it; otherwise false.
+        /// </summary>
+        return heap.use_count() > 1;
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of elements contained in the collection.
+        /// </summary>
+        return heap->get_size();
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no elements in the collection;
+        /// otherwise false.
+        /// </summary>
+        return heap->is_empty();
+    }
+
+    const fhNode<T, Key>* find_min() const {
+        /// <summary>
+        /// Return the minimum node in the collection, without removing it.
+        /// </summary>
+        /// <returns>Pointer to the minimum
+        /// node in the collection.</returns>
+        return heap->find_min();
+    }
+
+    const T& get_value(const handle &node) const {
+        /// <summary>
+        /// Returns the value contained by the node referred to by a handle.
+        /// </summary>
+        return heap->get_value(node);
+    }
+
+    Key get_priority(const handle &node) const {
+        /// <summary>
+        /// Returns the priority of the node referred to by a handle.
+        /// </summary>
+        return heap->get_priority(node);
+    }
+
+    handle insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the collection.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return get_heap().insert(value, priority);
+    }
+
+    handle insert(T &&value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the collection, moving value into the
+        /// node.
+        /// </summary>
+        /// <param name="value">Generic object contained by the node.</param>
+        /// <param name="priority">Priority key value.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return get_heap().insert(std::move(value), priority);
+    }
+
+    template <typename... Args>
+    handle emplace(const Key &priority, Args&&... args) {
+        /// <summary>
+        /// Insert a new Node into the collection, the value is constructed
+        /// in place inside the node.
+        /// </summary>
+        /// <param name="priority">Priority key value.</param>
+        /// <param name="args">Arguments the generic object contained by
+        /// the node is constructed from.</param>
+        /// <returns>Handle to the inserted node.</returns>
+        return get_heap().emplace(priority, std::forward<Args>(args)...);
+    }
+
+    void delete_min() {
+        /// <summary>
+        /// Delete the minimum node of the collection.
+        /// </summary>
+        get_heap().delete_min();
+    }
+
+    std::pair<T, Key> extract_min() {
+        /// <summary>
+        /// Return the value and priority of the minimum node in the
+        /// collection, and remove it. Throws std::out_of_range if the
+        /// collection is empty.
+        /// </summary>
+        /// <returns>Value and priority of the minimum
+        /// node in the collection.</returns>
+        return get_heap().extract_min();
+    }
+
+    void decrease_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Lower the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        get_heap().decrease_key(node, new_priority);
+    }
+
+    void increase_key(const handle &node, const Key &new_priority) {
+        /// <summary>
+        /// Raise the priority of the node referred to by a handle.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        /// <param name="new_priority">New priority of the node.</param>
+        get_heap().increase_key(node, new_priority);
+    }
+
+    void erase(const handle &node) {
+        /// <summary>
+        /// Remove the node referred to by a handle from the collection.
+        /// </summary>
+        /// <param name="node">Handle to the target node.</param>
+        get_heap().erase(node);
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every node from the collection, snapshots sharing the
+        /// forest keep it.
+        /// </summary>
+        if (is_shared()) {
+            heap = std::make_shared<heap_type>(heap->get_compare(), heap->get_allocator());
+            owner = true;
+        }
+        else {
+            heap->clear();
+        }
+    }
+
+    heap_type& get_heap() {
+        /// <summary>
+        /// Returns the FibonacciHeap holding this collection's forest,
+        /// for changes not forwarded by this class. The forest is cloned
+        /// first if it is shared, so the reference must not be kept
+        /// across a later snapshot.
+        /// </summary>
+        /// <returns>FibonacciHeap only this collection uses.</returns>
+        detach();
+        return *heap;
+    }
+
+private:
+    void detach() {
+        /// <summary>
+        /// Make sure no snapshot shares the forest before it is changed.
+        /// The owner keeps its nodes and leaves a clone behind for the
+        /// snapshots, a snapshot takes a clone for itself.
+        /// </summary>
+        if (!is_shared()) {
+            owner = true;
+            return;
+        }
+
+        if (owner) {
+            std::shared_ptr<heap_type> own_heap = std::make_shared<heap_type>(std::move(*heap));
+            *heap = own_heap->clone();
+            heap = std::move(own_heap);
+        }
+        else {
+            heap = std::make_shared<heap_type>(heap->clone());
+            owner = true;
+        }
+    }
+};
@@ -0,0 +1,508 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: TimerWheel
+    File: TimerWheel.h
+
+    Deadline ordered timers, a hierarchical timing wheel in front of a
+    FibonacciHeap. Timers due in the near future wait in the buckets of
+    the wheel, and only move into the heap once their bucket is about
+    to fire, so a timer cancelled before then never touches the heap's
+    trees. Timers further out than the wheel reaches go straight into
+    the heap.
+
+    The wheel has 4 levels of 64 buckets, a bucket of level l spans
+    64^l slots, and a slot spans 2^resolution ticks. Timers due in the
+    same slot are ordered exactly by the heap when they fire.
+
+    Cost summary:
+    schedule           O(1)
+    cancel             O(1), O(log(n)) if already in the heap
+    reschedule         O(1), O(log(n)) if already in the heap
+    advance            O(b + f log(n)), b occupied buckets passed,
+                       f timers fired
+*/
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+
+template <typename T>
+struct fhTimer {
+/// <summary>
+/// Timer of a TimerWheel, kept in a bucket of the wheel or in the heap.
+/// </summary>
+/// <typeparam name="T">Generic object contained within the timer</typeparam>
+    T value;
+    std::uint64_t deadline;
+
+    // Neighbours in the bucket, the first timer of a bucket has no prev.
+    fhTimer<T> *prev = nullptr;
+    fhTimer<T> *next = nullptr;
+
+    // Node of the timer in the heap, only set while it is in the heap.
+    fhHandle<fhTimer<T>*, std::uint64_t> node;
+
+    // Level * 64 + bucket of the timer in the wheel, in_heap otherwise.
+    unsigned bucket = 0;
+
+    static constexpr unsigned in_heap = ~0u;
+
+    template <typename V>
+    fhTimer(V &&value, std::uint64_t deadline) : value(std::forward<V>(value)), deadline(deadline) {}
+};
+
+
+template <typename T>
+class fhTimerHandle {
+/// <summary>
+/// Reference to a timer returned by TimerWheel::schedule, stays valid
+/// until the timer fires or is cancelled.
+/// </summary>
+/// <typeparam name="T">Generic object contained within the timer</typeparam>
+private:
+    template <typename, typename> friend class TimerWheel;
+
+    // Timer this handle refers to.
+    fhTimer<T> *timer = nullptr;
+
+    explicit fhTimerHandle(fhTimer<T> *timer) : timer(timer) {}
+
+public:
+    // A default constructed handle does not refer to any timer.
+    fhTimerHandle() {}
+
+    explicit operator bool() const { return timer != nullptr; }
+
+    bool operator==(const fhTimerHandle<T> &other) const { return timer == other.timer; }
+
+    bool operator!=(const fhTimerHandle<T> &other) const { return timer != other.timer; }
+};
+
+
+template <typename T, typename Alloc = std::allocator<T>>
+class TimerWheel {
+/// <summary>
+/// Timers ordered by deadline, fired by advancing the wheel's time.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection</typeparam>
+/// <typeparam name="Alloc">Allocator used for the timers and the heap.</typeparam>
+public:
+    // Handle to a timer in the collection, returned by schedule.
+    typedef fhTimerHandle<T> handle;
+
+private:
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<fhTimer<T>> timer_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<fhTimer<T>*> heap_allocator;
+    typedef std::allocator_traits<timer_allocator> timer_traits;
+
+    static constexpr unsigned levels = 4;
+    static constexpr unsigned level_bits = 6;
+    static constexpr unsigned buckets = 1u << level_bits;
+    static constexpr std::uint64_t bucket_mask = buckets - 1;
+
+    // Timers of every bucket, and a bit set for every bucket that holds
+    // any.
+    fhTimer<T> *wheel[levels][buckets] = {};
+    std::uint64_t occupied[levels] = {};
+
+    // Timers whose slot has come, and timers beyond the wheel.
+    FibonacciHeap<fhTimer<T>*, std::uint64_t, std::less<std::uint64_t>, heap_allocator> heap;
+
+    // Time in ticks, and the slot it falls in.
+    std::uint64_t now;
+    std::uint64_t slot;
+    unsigned resolution;
+
+    std::size_t size = 0;
+
+    // Storage of timers that fired or were cancelled, reused by
+    // schedule.
+    timer_allocator alloc;
+    std::vector<fhTimer<T>*> unused;
+
+public:
+    /*
+    Time constructor, the TimerWheel is initialized to an empty
+    collection at time now.
+
+    @parameter: now (uint64_t) - Time the wheel starts at, in ticks.
+    @parameter: resolution (unsigned) - Ticks per slot of the wheel, as
+                                        a power of two, 0 for slots of
+                                        a single tick.
+    @parameter: alloc (Alloc) - Allocator used for the timers and the
+                                heap.
+    */
+    explicit TimerWheel(std::uint64_t now = 0, unsigned resolution = 0, const Alloc &alloc = Alloc())
+        : heap(std::less<std::uint64_t>(), heap_allocator(alloc)), now(now), slot(now >> resolution),
+          resolution(resolution), alloc(alloc) {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /*
+    Destructor, frees every timer left.
+    */
+    ~TimerWheel() {
+        clear();
+        for (fhTimer<T> *timer : unused) { timer_traits::deallocate(alloc, timer, 1); }
+    }
+
+    handle schedule(const T &value, std::uint64_t deadline) {
+        /// <summary>
+        /// Add a timer firing at deadline, or at the next advance if the
+        /// deadline has passed.
+        /// </summary>
+        /// <param name="value">Value of the timer.</param>
+        /// <param name="deadline">Time the timer fires at, in ticks.</param>
+        /// <returns>Handle to the new timer.</returns>
+        return handle(place(create(value, deadline)));
+    }
+
+    handle schedule(T &&value, std::uint64_t deadline) {
+        /// <summary>
+        /// Add a timer firing at deadline, moving value into the timer.
+        /// </summary>
+        /// <param name="value">Value of the timer.</param>
+        /// <param name="deadline">Time the timer fires at, in ticks.</param>
+        /// <returns>Handle to the new timer.</returns>
+        return handle(place(create(std::move(value), deadline)));
+    }
+
+    void cancel(const handle &timer) {
+        /// <summary>
+        /// Remove a timer that has not fired, the handle is no longer
+        /// valid after this call.
+        /// </summary>
+        /// <param name="timer">Handle to the target timer.</param>
+        if (!timer) { return; }
+
+        unplace(timer.timer);
+        destroy(timer.timer);
+    }
+
+    void reschedule(const handle &timer, std::uint64_t deadline) {
+        /// <summary>
+        /// Move a timer that has not fired to a new deadline, the handle
+        /// stays valid.
+        /// </summary>
+        /// <param name="timer">Handle to the target timer.</param>
+        /// <param name="deadline">New time the timer fires at.</param>
+        if (!timer) { return; }
+
+        unplace(timer.timer);
+        timer.timer->deadline = deadline;
+        place(timer.timer);
+    }
+
+    template <typename OutputIt>
+    OutputIt advance(std::uint64_t time, OutputIt out) {
+        /// <summary>
+        /// Move the wheel forward to time and fire every timer due by
+        /// then, in deadline order. Time never moves back, an earlier
+        /// time only fires the timers already due.
+        /// </summary>
+        /// <param name="time">New time of the wheel, in ticks.</param>
+        /// <param name="out">Iterator the std::pair of each fired timer's
+        /// value and deadline is written to.</param>
+        /// <returns>Iterator past the last pair written.</returns>
+        if (time > now) {
+            std::uint64_t target = time >> resolution;
+
+            // Move the timers of every first level bucket passed into the
+            // heap, then jump to the next occupied bucket of the higher
+            // levels and spread it over the levels below, skipping the
+            // rotations in between.
+            while (slot < target) {
+                if (!size || size == heap.get_size()) {
+                    slot = target;
+                    break;
+                }
+
+                std::uint64_t base = slot & ~bucket_mask;
+                unsigned from = static_cast<unsigned>(slot & bucket_mask);
+                if (target - base <= bucket_mask) {
+                    promote(from, static_cast<unsigned>(target & bucket_mask));
+                    slot = target;
+                    break;
+                }
+
+                promote(from, static_cast<unsigned>(bucket_mask));
+                std::uint64_t next = next_occupied();
+                if (next > target) {
+                    slot = target;
+                    break;
+                }
+
+                // A timer due in the new slot is spread straight into
+                // the heap.
+                slot = next;
+                cascade();
+            }
+            now = time;
+        }
+
+        // Every timer due is in the heap now.
+        while (fhNode<fhTimer<T>*, std::uint64_t> *min = heap.find_min()) {
+            if (min->priority > now) { break; }
+
+            fhTimer<T> *timer = heap.extract_min().first;
+            *out = std::pair<T, std::uint64_t>(std::move(timer->value), timer->deadline);
+            ++out;
+            destroy(timer);
+        }
+        return out;
+    }
+
+    void clear() {
+        /// <summary>
+        /// Remove every timer without firing it, every handle is no
+        /// longer valid after this call.
+        /// </summary>
+        for (unsigned level = 0; level < levels; ++level) {
+            for (unsigned i = 0; i < buckets; ++i) {
+                fhTimer<T> *timer = wheel[level][i];
+                wheel[level][i] = nullptr;
+                while (timer) {
+                    fhTimer<T> *next = timer->next;
+                    destroy(timer);
+                    timer = next;
+                }
+            }
+            occupied[level] = 0;
+        }
+
+        while (!heap.is_empty()) { destroy(heap.extract_min().first); }
+    }
+
+    const T& get_value(const handle &timer) const {
+        /// <summary>
+        /// Returns the value of the timer referred to by a handle.
+        /// </summary>
+        /// <param name="timer">Handle to the target timer.</param>
+        /// <returns>Value of the timer.</returns>
+        return timer.timer->value;
+    }
+
+    std::uint64_t get_deadline(const handle &timer) const {
+        /// <summary>
+        /// Returns the deadline of the timer referred to by a handle.
+        /// </summary>
+        /// <param name="timer">Handle to the target timer.</param>
+        /// <returns>Deadline of the timer, in ticks.</returns>
+        return timer.timer->deadline;
+    }
+
+    std::uint64_t get_time() const {
+        /// <summary>
+        /// Returns the time of the wheel, in ticks.
+        /// </summary>
+        return now;
+    }
+
+    std::size_t get_size() const {
+        /// <summary>
+        /// Returns the number of timers that have not fired.
+        /// </summary>
+        return size;
+    }
+
+    bool is_empty() const {
+        /// <summary>
+        /// Returns true if there are no timers left to fire.
+        /// </summary>
+        return !size;
+    }
+
+private:
+    template <typename V>
+    fhTimer<T>* create(V &&value, std::uint64_t deadline) {
+        /// <summary>
+        /// Construct a timer, in storage left by an earlier one if any.
+        /// </summary>
+        fhTimer<T> *timer;
+        if (unused.empty()) {
+            timer = timer_traits::allocate(alloc, 1);
+        }
+        else {
+            timer = unused.back();
+            unused.pop_back();
+        }
+
+        try {
+            timer_traits::construct(alloc, timer, std::forward<V>(value), deadline);
+        }
+        catch (...) {
+            unused.push_back(timer);
+            throw;
+        }
+
+        ++size;
+        return timer;
+    }
+
+    void destroy(fhTimer<T> *timer) {
+        /// <summary>
+        /// Destroy a timer that is in neither the wheel nor the heap,
+        /// keeping its storage for the next schedule.
+        /// </summary>
+        timer_traits::destroy(alloc, timer);
+        unused.push_back(timer);
+        --size;
+    }
+
+    fhTimer<T>* place(fhTimer<T> *timer) {
+        /// <summary>
+        /// Put a timer in the wheel, in the bucket of the highest level
+        /// whose position differs between its slot and the current one.
+        /// Timers whose slot has come or is beyond the wheel go in the
+        /// heap.
+        /// </summary>
+        std::uint64_t timer_slot = timer->deadline >> resolution;
+        std::uint64_t differ = timer_slot ^ slot;
+
+        unsigned level = 0;
+        while (level < levels && (differ >> (level_bits * (level + 1)))) { ++level; }
+
+        if (timer_slot <= slot || level == levels) {
+            timer->bucket = fhTimer<T>::in_heap;
+            timer->node = heap.insert(timer, timer->deadline);
+            return timer;
+        }
+
+        unsigned i = static_cast<unsigned>((timer_slot >> (level_bits * level)) & bucket_mask);
+        timer->bucket = level * buckets + i;
+        timer->prev = nullptr;
+        timer->next = wheel[level][i];
+        if (timer->next) { timer->next->prev = timer; }
+        wheel[level][i] = timer;
+        occupied[level] |= std::uint64_t(1) << i;
+        return timer;
+    }
+
+    void unplace(fhTimer<T> *timer) {
+        /// <summary>
+        /// Take a timer out of its bucket, or out of the heap.
+        /// </summary>
+        if (timer->bucket == fhTimer<T>::in_heap) {
+            heap.erase(timer->node);
+            timer->node = fhHandle<fhTimer<T>*, std::uint64_t>();
+            return;
+        }
+
+        unsigned level = timer->bucket / buckets;
+        unsigned i = timer->bucket % buckets;
+        if (timer->prev) {
+            timer->prev->next = timer->next;
+        }
+        else {
+            wheel[level][i] = timer->next;
+            if (!timer->next) { occupied[level] &= ~(std::uint64_t(1) << i); }
+        }
+        if (timer->next) { timer->next->prev = timer->prev; }
+    }
+
+    void promote(unsigned from, unsigned to) {
+        /// <summary>
+        /// Move the timers of the first level buckets after from, up to
+        /// and including to, into the heap.
+        /// </summary>
+        if (from >= to) { return; }
+
+        // Bits from + 1 to to, 2 << 63 wraps to 0 so to = 63 keeps
+        // every bit above from.
+        std::uint64_t range = ((std::uint64_t(2) << to) - 1) & ~((std::uint64_t(2) << from) - 1);
+
+        for (std::uint64_t due = occupied[0] & range; due; due &= due - 1) {
+            promote_bucket(countr_zero(due));
+        }
+    }
+
+    void promote_bucket(unsigned i) {
+        /// <summary>
+        /// Move the timers of a first level bucket into the heap.
+        /// </summary>
+        fhTimer<T> *timer = wheel[0][i];
+        wheel[0][i] = nullptr;
+        occupied[0] &= ~(std::uint64_t(1) << i);
+
+        while (timer) {
+            fhTimer<T> *next = timer->next;
+            timer->bucket = fhTimer<T>::in_heap;
+            timer->node = heap.insert(timer, timer->deadline);
+            timer = next;
+        }
+    }
+
+    std::uint64_t next_occupied() const {
+        /// <summary>
+        /// Returns the first slot of the next occupied bucket above the
+        /// first level, which must be empty, or the largest slot if there
+        /// is none. The occupied buckets of a level all come after the
+        /// current slot, and before the next bucket of any higher level,
+        /// so the next one is on the lowest occupied level.
+        /// </summary>
+        for (unsigned level = 1; level < levels; ++level) {
+            if (!occupied[level]) { continue; }
+
+            unsigned shift = level_bits * level;
+            std::uint64_t above = ~((std::uint64_t(1) << (shift + level_bits)) - 1);
+            return (slot & above) | (std::uint64_t(countr_zero(occupied[level])) << shift);
+        }
+        return ~std::uint64_t(0);
+    }
+
+    void cascade() {
+        /// <summary>
+        /// After the first level wraps around, spread the timers of the
+        /// bucket reached on every higher level that moved over the
+        /// levels below it.
+        /// </summary>
+        for (unsigned level = 1; level < levels; ++level) {
+            unsigned i = static_cast<unsigned>((slot >> (level_bits * level)) & bucket_mask);
+
+            fhTimer<T> *timer = wheel[level][i];
+            wheel[level][i] = nullptr;
+            occupied[level] &= ~(std::uint64_t(1) << i);
+            while (timer) {
+                fhTimer<T> *next = timer->next;
+                place(timer);
+                timer = next;
+            }
+
+            // Higher levels only moved if this one wrapped around too.
+            if (i) { break; }
+        }
+    }
+
+    static unsigned countr_zero(std::uint64_t bits) {
+        /// <summary>
+        /// Returns the index of the lowest bit set, bits is not 0.
+        /// </summary>
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+        unsigned count = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+};
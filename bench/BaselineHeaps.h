@@ -0,0 +1,299 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: BaselineHeaps
+    File: BaselineHeaps.h
+
+    Baseline heaps the benchmarks compare FibonacciHeap against: a
+    two-pass pairing heap (Fredman, Sedgewick, Sleator and Tarjan,
+    1986) and a d-ary heap with decrease-key. Both take no more care
+    than a benchmark needs, nodes are pooled like FibonacciHeap's so
+    the allocator doesn't decide the comparison.
+*/
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename T, typename Key = long long>
+class PairingHeap {
+/// <summary>
+/// Min pairing heap, every node links to its first child, its next
+/// sibling, and the node before it (its parent if it is a first child).
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+public:
+    struct node {
+        node *child = nullptr;
+        node *next = nullptr;
+        node *prev = nullptr;
+        Key priority;
+        T value;
+    };
+
+    // Handle to a Node in the collection, returned by insert.
+    typedef node* handle;
+
+private:
+    // Slabs the nodes are carved from, and the freed nodes.
+    std::vector<std::unique_ptr<node[]>> slabs;
+    std::size_t slab_used = 0, slab_size = 0;
+    std::vector<node*> free_nodes;
+
+    node *root = nullptr;
+    std::size_t size = 0;
+
+    // Roots gathered by the first pass of delete_min.
+    std::vector<node*> pairs;
+
+public:
+    PairingHeap() = default;
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    handle insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new Node into the collection.
+        /// </summary>
+        node *new_node = allocate();
+        new_node->child = new_node->next = new_node->prev = nullptr;
+        new_node->priority = priority;
+        new_node->value = value;
+
+        root = root ? meld(root, new_node) : new_node;
+        ++size;
+        return new_node;
+    }
+
+    const node* find_min() const { return root; }
+
+    bool is_empty() const { return !root; }
+
+    std::size_t get_size() const { return size; }
+
+    void delete_min() {
+        /// <summary>
+        /// Remove the minimum node, pairing its children left to right
+        /// and melding the pairs right to left.
+        /// </summary>
+        if (!root) { return; }
+
+        node *old_root = root;
+        pairs.clear();
+
+        node *curr = root->child;
+        while (curr) {
+            node *first = curr, *second = curr->next;
+            if (!second) {
+                first->next = first->prev = nullptr;
+                pairs.push_back(first);
+                break;
+            }
+            curr = second->next;
+            first->next = first->prev = second->next = second->prev = nullptr;
+            pairs.push_back(meld(first, second));
+        }
+
+        root = nullptr;
+        for (std::size_t i = pairs.size(); i-- > 0;) {
+            root = root ? meld(pairs[i], root) : pairs[i];
+        }
+
+        free_nodes.push_back(old_root);
+        --size;
+    }
+
+    void decrease_key(handle curr, const Key &new_priority) {
+        /// <summary>
+        /// Lower the priority of a node, cutting its subtree and melding
+        /// it with the root.
+        /// </summary>
+        curr->priority = new_priority;
+        if (curr == root) { return; }
+
+        if (curr->prev->child == curr) { curr->prev->child = curr->next; }
+        else { curr->prev->next = curr->next; }
+        if (curr->next) { curr->next->prev = curr->prev; }
+        curr->next = curr->prev = nullptr;
+
+        root = meld(root, curr);
+    }
+
+    void merge(PairingHeap &other) {
+        /// <summary>
+        /// Move every node of other into this collection in O(1).
+        /// </summary>
+        if (!other.root) { return; }
+
+        root = root ? meld(root, other.root) : other.root;
+        size += other.size;
+        for (auto &curr_slab : other.slabs) { slabs.push_back(std::move(curr_slab)); }
+        free_nodes.insert(free_nodes.end(), other.free_nodes.begin(), other.free_nodes.end());
+
+        other.slabs.clear();
+        other.free_nodes.clear();
+        other.slab_used = other.slab_size = 0;
+        other.root = nullptr;
+        other.size = 0;
+    }
+
+private:
+    node* meld(node *a, node *b) {
+        /// <summary>
+        /// Make the root with the larger priority the first child of the
+        /// other, and return the new root.
+        /// </summary>
+        if (b->priority < a->priority) { std::swap(a, b); }
+
+        b->prev = a;
+        b->next = a->child;
+        if (a->child) { a->child->prev = b; }
+        a->child = b;
+        return a;
+    }
+
+    node* allocate() {
+        /// <summary>
+        /// Returns a freed node, or the next one of the newest slab.
+        /// </summary>
+        if (!free_nodes.empty()) {
+            node *curr = free_nodes.back();
+            free_nodes.pop_back();
+            return curr;
+        }
+
+        if (slab_used == slab_size) {
+            slab_size = slab_size ? slab_size * 2 : 32;
+            slabs.emplace_back(new node[slab_size]);
+            slab_used = 0;
+        }
+        return &slabs.back()[slab_used++];
+    }
+};
+
+
+template <typename T, typename Key = long long, unsigned D = 4>
+class DaryHeap {
+/// <summary>
+/// Min d-ary heap in an array, with the position of every element kept
+/// so decrease-key needs no search.
+/// </summary>
+/// <typeparam name="T">Generic object contained within this collection.</typeparam>
+/// <typeparam name="Key">Type of the priorities.</typeparam>
+/// <typeparam name="D">Number of children of every node.</typeparam>
+private:
+    struct entry {
+        Key priority;
+        T value;
+        std::uint32_t position;
+    };
+
+    // Entries by handle, and the handles in heap order.
+    std::vector<entry> entries;
+    std::vector<std::uint32_t> heap;
+    std::vector<std::uint32_t> free_entries;
+
+public:
+    // Handle to an element in the collection, returned by insert.
+    typedef std::uint32_t handle;
+
+    handle insert(const T &value, const Key &priority) {
+        /// <summary>
+        /// Insert a new element into the collection.
+        /// </summary>
+        handle id;
+        if (!free_entries.empty()) {
+            id = free_entries.back();
+            free_entries.pop_back();
+            entries[id] = entry{ priority, value, 0 };
+        }
+        else {
+            id = static_cast<handle>(entries.size());
+            entries.push_back(entry{ priority, value, 0 });
+        }
+
+        heap.push_back(id);
+        sift_up(static_cast<std::uint32_t>(heap.size() - 1));
+        return id;
+    }
+
+    const Key& min_priority() const { return entries[heap[0]].priority; }
+
+    bool is_empty() const { return heap.empty(); }
+
+    std::size_t get_size() const { return heap.size(); }
+
+    void delete_min() {
+        /// <summary>
+        /// Remove the minimum element.
+        /// </summary>
+        free_entries.push_back(heap[0]);
+        heap[0] = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            entries[heap[0]].position = 0;
+            sift_down(0);
+        }
+    }
+
+    void decrease_key(handle id, const Key &new_priority) {
+        /// <summary>
+        /// Lower the priority of an element.
+        /// </summary>
+        entries[id].priority = new_priority;
+        sift_up(entries[id].position);
+    }
+
+private:
+    void sift_up(std::uint32_t position) {
+        std::uint32_t id = heap[position];
+        while (position > 0) {
+            std::uint32_t parent = (position - 1) / D;
+            if (!(entries[id].priority < entries[heap[parent]].priority)) { break; }
+
+            heap[position] = heap[parent];
+            entries[heap[position]].position = position;
+            position = parent;
+        }
+        heap[position] = id;
+        entries[id].position = position;
+    }
+
+    void sift_down(std::uint32_t position) {
+        std::uint32_t id = heap[position];
+        std::uint32_t count = static_cast<std::uint32_t>(heap.size());
+
+        while (true) {
+            std::uint32_t first = position * D + 1;
+            if (first >= count) { break; }
+
+            std::uint32_t best = first;
+            std::uint32_t last = first + D < count ? first + D : count;
+            for (std::uint32_t child = first + 1; child < last; ++child) {
+                if (entries[heap[child]].priority < entries[heap[best]].priority) { best = child; }
+            }
+            if (!(entries[heap[best]].priority < entries[id].priority)) { break; }
+
+            heap[position] = heap[best];
+            entries[heap[position]].position = position;
+            position = best;
+        }
+        heap[position] = id;
+        entries[id].position = position;
+    }
+};
@@ -0,0 +1,413 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: FibonacciHeapBenchmark
+    File: FibonacciHeapBenchmark.cpp
+
+    Google Benchmark suite for FibonacciHeap and CompactFibonacciHeap,
+    with std::priority_queue, a pairing heap and a 4-ary heap as
+    baselines. Every benchmark runs over collection sizes from 1e3 up
+    to FH_BENCH_MAX_SIZE, in powers of 10, and over four priority
+    distributions: uniform random, ascending, descending and few
+    distinct priorities.
+*/
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "BaselineHeaps.h"
+#include "CompactFibonacciHeap.h"
+#include "FibonacciHeap.h"
+#include "IndexedFibonacciHeap.h"
+
+#ifndef FH_BENCH_MAX_SIZE
+#define FH_BENCH_MAX_SIZE 1000000
+#endif
+
+namespace {
+
+typedef long long key_type;
+
+// Priority distributions the benchmarks run over, the second argument
+// of every benchmark.
+enum distribution { uniform, ascending, descending, few_distinct, distribution_count };
+
+const char *distribution_names[distribution_count] = { "uniform", "ascending", "descending", "few_distinct" };
+
+// Number of keys lowered by the decrease-key benchmarks, finding a node
+// without a handle costs O(n) so lowering every node would not finish.
+constexpr std::size_t decrease_count = 1024;
+
+std::vector<key_type> make_keys(std::size_t count, int dist) {
+    /// <summary>
+    /// Returns count priorities drawn from a distribution, the same
+    /// ones every run.
+    /// </summary>
+    std::vector<key_type> keys(count);
+    std::mt19937_64 engine(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (dist) {
+        case ascending: keys[i] = static_cast<key_type>(i); break;
+        case descending: keys[i] = static_cast<key_type>(count - i); break;
+        case few_distinct: keys[i] = static_cast<key_type>(engine() % 16); break;
+        default: keys[i] = static_cast<key_type>(engine() % (count * 4)); break;
+        }
+    }
+    return keys;
+}
+
+std::vector<std::size_t> make_targets(std::size_t count) {
+    /// <summary>
+    /// Returns the indices of the nodes the decrease-key benchmarks
+    /// lower, at most decrease_count distinct indices below count.
+    /// </summary>
+    std::vector<std::size_t> targets(count);
+    for (std::size_t i = 0; i < count; ++i) { targets[i] = i; }
+
+    std::shuffle(targets.begin(), targets.end(), std::mt19937_64(count + 1));
+    targets.resize(std::min(count, decrease_count));
+    return targets;
+}
+
+void sizes(benchmark::internal::Benchmark *bench) {
+    /// <summary>
+    /// Registers every collection size with every priority distribution.
+    /// </summary>
+    std::vector<std::int64_t> counts;
+    for (std::int64_t count = 1000; count <= static_cast<std::int64_t>(FH_BENCH_MAX_SIZE); count *= 10) {
+        counts.push_back(count);
+    }
+    bench->ArgsProduct({ counts, { uniform, ascending, descending, few_distinct } });
+    bench->ArgNames({ "n", "keys" });
+}
+
+void find_sizes(benchmark::internal::Benchmark *bench) {
+    /// <summary>
+    /// Registers the collection sizes finding a node by value is
+    /// practical for, up to 1e5.
+    /// </summary>
+    std::vector<std::int64_t> counts;
+    for (std::int64_t count = 1000; count <= std::min<std::int64_t>(FH_BENCH_MAX_SIZE, 100000); count *= 10) {
+        counts.push_back(count);
+    }
+    bench->ArgsProduct({ counts, { uniform, ascending, descending, few_distinct } });
+    bench->ArgNames({ "n", "keys" });
+}
+
+
+// Every heap is driven through an adapter with the same members:
+// insert, delete_min, decrease_key, is_empty, and where supported
+// merge and bulk.
+struct fibonacci_adapter {
+    typedef FibonacciHeap<int, key_type> heap_type;
+    typedef heap_type::handle handle;
+    heap_type heap;
+
+    handle insert(int value, key_type priority) { return heap.insert(value, priority); }
+    void delete_min() { heap.delete_min(); }
+    void decrease_key(handle node, key_type priority) { heap.decrease_key(node, priority); }
+    bool is_empty() { return heap.is_empty(); }
+    void merge(fibonacci_adapter &other) { heap.merge(std::move(other.heap)); }
+    void bulk(const std::vector<std::pair<int, key_type>> &items) { heap.insert_bulk(items.begin(), items.end()); }
+};
+
+struct compact_adapter {
+    typedef CompactFibonacciHeap<int, key_type> heap_type;
+    typedef heap_type::handle handle;
+    heap_type heap;
+
+    handle insert(int value, key_type priority) { return heap.insert(value, priority); }
+    void delete_min() { heap.delete_min(); }
+    void decrease_key(handle node, key_type priority) { heap.decrease_key(node, priority); }
+    bool is_empty() { return heap.is_empty(); }
+    void bulk(const std::vector<std::pair<int, key_type>> &items) {
+        heap.reserve(items.size());
+        for (const auto &item : items) { heap.insert(item.first, item.second); }
+    }
+};
+
+// std::priority_queue has no decrease-key, it is done the usual way by
+// pushing the value again with its lower priority, leaving the old
+// entry to be skipped later.
+struct priority_queue_adapter {
+    typedef std::pair<key_type, int> entry;
+    typedef int handle;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+
+    handle insert(int value, key_type priority) { heap.emplace(priority, value); return value; }
+    void delete_min() { heap.pop(); }
+    void decrease_key(handle value, key_type priority) { heap.emplace(priority, value); }
+    bool is_empty() { return heap.empty(); }
+    void merge(priority_queue_adapter &other) {
+        for (; !other.heap.empty(); other.heap.pop()) { heap.push(other.heap.top()); }
+    }
+    void bulk(const std::vector<std::pair<int, key_type>> &items) {
+        std::vector<entry> entries;
+        entries.reserve(items.size());
+        for (const auto &item : items) { entries.emplace_back(item.second, item.first); }
+        heap = decltype(heap)(std::greater<entry>(), std::move(entries));
+    }
+};
+
+struct pairing_adapter {
+    typedef PairingHeap<int, key_type> heap_type;
+    typedef heap_type::handle handle;
+    heap_type heap;
+
+    handle insert(int value, key_type priority) { return heap.insert(value, priority); }
+    void delete_min() { heap.delete_min(); }
+    void decrease_key(handle node, key_type priority) { heap.decrease_key(node, priority); }
+    bool is_empty() { return heap.is_empty(); }
+    void merge(pairing_adapter &other) { heap.merge(other.heap); }
+};
+
+struct dary_adapter {
+    typedef DaryHeap<int, key_type, 4> heap_type;
+    typedef heap_type::handle handle;
+    heap_type heap;
+
+    handle insert(int value, key_type priority) { return heap.insert(value, priority); }
+    void delete_min() { heap.delete_min(); }
+    void decrease_key(handle node, key_type priority) { heap.decrease_key(node, priority); }
+    bool is_empty() { return heap.is_empty(); }
+};
+
+
+void set_counters(benchmark::State &state, std::size_t operations) {
+    /// <summary>
+    /// Reports operations per second and the priority distribution.
+    /// </summary>
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * operations));
+    state.SetLabel(distribution_names[state.range(1)]);
+}
+
+template <typename Heap>
+void destroy(benchmark::State &state, std::unique_ptr<Heap> &heap) {
+    /// <summary>
+    /// Destroy a collection outside of the measured time, the heaps
+    /// free their nodes in very different ways and none of them is what
+    /// is being measured.
+    /// </summary>
+    benchmark::DoNotOptimize(heap->heap);
+    state.PauseTiming();
+    heap.reset();
+    state.ResumeTiming();
+}
+
+template <typename Heap>
+void build(Heap &heap, const std::vector<key_type> &keys, std::vector<typename Heap::handle> *handles = nullptr) {
+    /// <summary>
+    /// Insert every key, then insert and remove a minimum so the heaps
+    /// that defer work have done it before the measured operations.
+    /// </summary>
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto node = heap.insert(static_cast<int>(i), keys[i]);
+        if (handles) { handles->push_back(node); }
+    }
+    heap.insert(-1, std::numeric_limits<key_type>::min());
+    heap.delete_min();
+}
+
+template <typename Heap>
+void insert(benchmark::State &state) {
+    /// <summary>
+    /// Insert n nodes into an empty collection.
+    /// </summary>
+    std::vector<key_type> keys = make_keys(static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        std::unique_ptr<Heap> heap(new Heap);
+        for (std::size_t i = 0; i < keys.size(); ++i) { heap->insert(static_cast<int>(i), keys[i]); }
+        destroy(state, heap);
+    }
+    set_counters(state, keys.size());
+}
+
+template <typename Heap>
+void extract_min(benchmark::State &state) {
+    /// <summary>
+    /// Remove every node from a collection of n nodes in order.
+    /// </summary>
+    std::vector<key_type> keys = make_keys(static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Heap> heap(new Heap);
+        for (std::size_t i = 0; i < keys.size(); ++i) { heap->insert(static_cast<int>(i), keys[i]); }
+        state.ResumeTiming();
+
+        while (!heap->is_empty()) { heap->delete_min(); }
+        destroy(state, heap);
+    }
+    set_counters(state, keys.size());
+}
+
+template <typename Heap>
+void decrease_key(benchmark::State &state) {
+    /// <summary>
+    /// Lower the priority of up to decrease_count nodes of a collection
+    /// of n nodes, through the handles insert returned.
+    /// </summary>
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<key_type> keys = make_keys(count, static_cast<int>(state.range(1)));
+    std::vector<std::size_t> targets = make_targets(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Heap> heap(new Heap);
+        std::vector<typename Heap::handle> handles;
+        handles.reserve(count);
+        build(*heap, keys, &handles);
+        state.ResumeTiming();
+
+        for (std::size_t target : targets) {
+            heap->decrease_key(handles[target], keys[target] - static_cast<key_type>(count));
+        }
+        destroy(state, heap);
+    }
+    set_counters(state, targets.size());
+}
+
+void decrease_key_find(benchmark::State &state) {
+    /// <summary>
+    /// Lower the priority of up to decrease_count nodes of a
+    /// FibonacciHeap of n nodes by value and old priority, finding every
+    /// node first.
+    /// </summary>
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<key_type> keys = make_keys(count, static_cast<int>(state.range(1)));
+    std::vector<std::size_t> targets = make_targets(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<fibonacci_adapter> heap(new fibonacci_adapter);
+        build(*heap, keys);
+        state.ResumeTiming();
+
+        for (std::size_t target : targets) {
+            heap->heap.change_priority(static_cast<int>(target), keys[target], keys[target] - static_cast<key_type>(count));
+        }
+        destroy(state, heap);
+    }
+    set_counters(state, targets.size());
+}
+
+void decrease_key_index(benchmark::State &state) {
+    /// <summary>
+    /// Lower the priority of up to decrease_count nodes of an
+    /// IndexedFibonacciHeap of n nodes by value alone, looking every node
+    /// up in the index.
+    /// </summary>
+    std::size_t count = static_cast<std::size_t>(state.range(0));
+    std::vector<key_type> keys = make_keys(count, static_cast<int>(state.range(1)));
+    std::vector<std::size_t> targets = make_targets(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<IndexedFibonacciHeap<int, key_type>> heap(new IndexedFibonacciHeap<int, key_type>);
+        for (std::size_t i = 0; i < count; ++i) { heap->insert(static_cast<int>(i), keys[i]); }
+        heap->insert(-1, std::numeric_limits<key_type>::min());
+        heap->delete_min();
+        state.ResumeTiming();
+
+        for (std::size_t target : targets) {
+            heap->change_priority(static_cast<int>(target), keys[target] - static_cast<key_type>(count));
+        }
+
+        benchmark::DoNotOptimize(*heap);
+        state.PauseTiming();
+        heap.reset();
+        state.ResumeTiming();
+    }
+    set_counters(state, targets.size());
+}
+
+template <typename Heap>
+void meld(benchmark::State &state) {
+    /// <summary>
+    /// Combine two collections of n nodes.
+    /// </summary>
+    std::vector<key_type> keys = make_keys(static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Heap> heap(new Heap), other(new Heap);
+        build(*heap, keys);
+        build(*other, keys);
+        state.ResumeTiming();
+
+        heap->merge(*other);
+        destroy(state, heap);
+        other.reset();
+    }
+    set_counters(state, 1);
+}
+
+template <typename Heap>
+void bulk_build(benchmark::State &state) {
+    /// <summary>
+    /// Build a collection of n nodes from an array of (value, priority)
+    /// pairs in one call.
+    /// </summary>
+    std::vector<key_type> keys = make_keys(static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)));
+    std::vector<std::pair<int, key_type>> items;
+    items.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) { items.emplace_back(static_cast<int>(i), keys[i]); }
+
+    for (auto _ : state) {
+        std::unique_ptr<Heap> heap(new Heap);
+        heap->bulk(items);
+        destroy(state, heap);
+    }
+    set_counters(state, items.size());
+}
+
+}
+
+BENCHMARK_TEMPLATE(insert, fibonacci_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(insert, compact_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(insert, priority_queue_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(insert, pairing_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(insert, dary_adapter)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(extract_min, fibonacci_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(extract_min, compact_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(extract_min, priority_queue_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(extract_min, pairing_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(extract_min, dary_adapter)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(decrease_key, fibonacci_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(decrease_key, compact_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(decrease_key, priority_queue_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(decrease_key, pairing_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(decrease_key, dary_adapter)->Apply(sizes);
+BENCHMARK(decrease_key_find)->Apply(find_sizes);
+BENCHMARK(decrease_key_index)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(meld, fibonacci_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(meld, priority_queue_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(meld, pairing_adapter)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(bulk_build, fibonacci_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(bulk_build, compact_adapter)->Apply(sizes);
+BENCHMARK_TEMPLATE(bulk_build, priority_queue_adapter)->Apply(sizes);
@@ -0,0 +1,338 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: GraphBenchmark
+    File: GraphBenchmark.cpp
+
+    Google Benchmark suite for the routines of GraphAlgorithms.h, with
+    the usual binary heap versions as baselines: a std::priority_queue
+    that pushes a vertex again whenever its key is lowered and skips the
+    stale entries it pops. Every benchmark runs over graphs from 1e4 up
+    to FH_BENCH_MAX_SIZE vertices, in powers of 10, of two shapes: a
+    road network like grid, and a random graph of higher degree where
+    far more edges lower a key.
+*/
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "GraphAlgorithms.h"
+
+#ifndef FH_BENCH_MAX_SIZE
+#define FH_BENCH_MAX_SIZE 1000000
+#endif
+
+namespace {
+
+typedef long long weight_type;
+typedef fhCsrGraph<weight_type> graph_type;
+
+// Graph shapes the benchmarks run over, the second argument of every
+// benchmark.
+enum shape { road, random_degree, shape_count };
+
+const char *shape_names[shape_count] = { "road", "random" };
+
+// Edges leaving every vertex of the random graphs.
+constexpr std::uint32_t random_degree_edges = 16;
+
+std::uint32_t grid_side(std::uint32_t vertices) {
+    /// <summary>
+    /// Returns the side of the square grid with about vertices vertices.
+    /// </summary>
+    std::uint32_t side = 1;
+    while (static_cast<std::uint64_t>(side + 1) * (side + 1) <= vertices) { ++side; }
+    return side;
+}
+
+graph_type make_graph(std::uint32_t vertices, int graph_shape) {
+    /// <summary>
+    /// Returns an undirected graph of a shape, the same one every run.
+    /// Road graphs are a square grid, every vertex joined to its four
+    /// neighbours, with weights from 1 to 1000 so the grid distance is a
+    /// consistent A* heuristic. Random graphs join every vertex to
+    /// random_degree_edges / 2 random vertices.
+    /// </summary>
+    std::mt19937_64 engine(vertices + graph_shape);
+    std::vector<graph_type::edge> edges;
+
+    if (graph_shape == road) {
+        std::uint32_t side = grid_side(vertices);
+        vertices = side * side;
+        edges.reserve(static_cast<std::size_t>(vertices) * 2);
+
+        for (std::uint32_t v = 0; v < vertices; ++v) {
+            if (v % side + 1 < side) { edges.push_back({ v, v + 1, 1 + static_cast<weight_type>(engine() % 1000) }); }
+            if (v + side < vertices) { edges.push_back({ v, v + side, 1 + static_cast<weight_type>(engine() % 1000) }); }
+        }
+    }
+    else {
+        edges.reserve(static_cast<std::size_t>(vertices) * random_degree_edges / 2);
+
+        for (std::uint32_t v = 0; v < vertices; ++v) {
+            for (std::uint32_t i = 0; i < random_degree_edges / 2; ++i) {
+                std::uint32_t w = static_cast<std::uint32_t>(engine() % vertices);
+                edges.push_back({ v, w, 1 + static_cast<weight_type>(engine() % 1000) });
+            }
+        }
+    }
+    return graph_type(vertices, edges, true);
+}
+
+const graph_type& get_graph(benchmark::State &state) {
+    /// <summary>
+    /// Returns the graph a benchmark runs over, kept between benchmarks
+    /// on the same graph since building the largest ones takes longer
+    /// than searching them.
+    /// </summary>
+    static graph_type graph;
+    static std::int64_t built[2] = { -1, -1 };
+
+    if (built[0] != state.range(0) || built[1] != state.range(1)) {
+        graph = make_graph(static_cast<std::uint32_t>(state.range(0)), static_cast<int>(state.range(1)));
+        built[0] = state.range(0);
+        built[1] = state.range(1);
+    }
+    return graph;
+}
+
+void sizes(benchmark::internal::Benchmark *bench) {
+    /// <summary>
+    /// Registers every graph size with every shape.
+    /// </summary>
+    std::vector<std::int64_t> counts;
+    for (std::int64_t count = 10000; count <= static_cast<std::int64_t>(FH_BENCH_MAX_SIZE); count *= 10) {
+        counts.push_back(count);
+    }
+    if (counts.empty()) { counts.push_back(static_cast<std::int64_t>(FH_BENCH_MAX_SIZE)); }
+
+    bench->ArgsProduct({ counts, { road, random_degree } });
+    bench->ArgNames({ "n", "graph" });
+    bench->Unit(benchmark::kMillisecond);
+}
+
+void road_sizes(benchmark::internal::Benchmark *bench) {
+    /// <summary>
+    /// Registers every graph size of the road graphs only, the grid
+    /// heuristic means nothing on the random graphs.
+    /// </summary>
+    std::vector<std::int64_t> counts;
+    for (std::int64_t count = 10000; count <= static_cast<std::int64_t>(FH_BENCH_MAX_SIZE); count *= 10) {
+        counts.push_back(count);
+    }
+    if (counts.empty()) { counts.push_back(static_cast<std::int64_t>(FH_BENCH_MAX_SIZE)); }
+
+    bench->ArgsProduct({ counts, { road } });
+    bench->ArgNames({ "n", "graph" });
+    bench->Unit(benchmark::kMillisecond);
+}
+
+void set_counters(benchmark::State &state, const graph_type &graph) {
+    /// <summary>
+    /// Reports edges per second and the graph shape.
+    /// </summary>
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * graph.get_edge_count()));
+    state.SetLabel(shape_names[state.range(1)]);
+}
+
+
+// Binary heap baselines, every lowered key is pushed again and the
+// stale entries are skipped when popped.
+typedef std::pair<weight_type, std::uint32_t> entry;
+typedef std::priority_queue<entry, std::vector<entry>, std::greater<entry>> binary_heap;
+
+template <typename Heuristic>
+std::vector<weight_type> lazy_shortest_paths(const graph_type &graph, std::uint32_t source, std::uint32_t target,
+                                             Heuristic heuristic) {
+    /// <summary>
+    /// Best first search with a lazy deletion binary heap, the
+    /// counterpart of fhDijkstra and fhAstar.
+    /// </summary>
+    std::vector<weight_type> distance(graph.get_vertex_count(), fhShortestPaths<weight_type>::unreached);
+    binary_heap heap;
+
+    distance[source] = 0;
+    heap.push(entry(heuristic(source), source));
+
+    while (!heap.empty()) {
+        entry min = heap.top();
+        heap.pop();
+
+        std::uint32_t v = min.second;
+        if (min.first - heuristic(v) > distance[v]) { continue; }
+        if (v == target) { break; }
+
+        for (std::uint32_t i = graph.offsets[v]; i < graph.offsets[v + 1]; ++i) {
+            std::uint32_t w = graph.targets[i];
+            weight_type relaxed = distance[v] + graph.weights[i];
+            if (relaxed < distance[w]) {
+                distance[w] = relaxed;
+                heap.push(entry(relaxed + heuristic(w), w));
+            }
+        }
+    }
+    return distance;
+}
+
+weight_type lazy_prim(const graph_type &graph) {
+    /// <summary>
+    /// Prim's minimum spanning forest with a lazy deletion binary heap,
+    /// returns the weight of the forest.
+    /// </summary>
+    std::uint32_t vertices = graph.get_vertex_count();
+    std::vector<bool> joined(vertices, false);
+    binary_heap heap;
+    weight_type weight = 0;
+
+    for (std::uint32_t root = 0; root < vertices; ++root) {
+        if (joined[root]) { continue; }
+        heap.push(entry(0, root));
+
+        while (!heap.empty()) {
+            entry min = heap.top();
+            heap.pop();
+
+            std::uint32_t v = min.second;
+            if (joined[v]) { continue; }
+            joined[v] = true;
+            weight += min.first;
+
+            for (std::uint32_t i = graph.offsets[v]; i < graph.offsets[v + 1]; ++i) {
+                if (!joined[graph.targets[i]]) { heap.push(entry(graph.weights[i], graph.targets[i])); }
+            }
+        }
+    }
+    return weight;
+}
+
+struct grid_distance {
+    /// <summary>
+    /// A* heuristic of the road graphs, the number of grid steps to the
+    /// target, every step weighs at least 1.
+    /// </summary>
+    std::uint32_t side;
+    std::uint32_t target;
+
+    weight_type operator()(std::uint32_t v) const {
+        weight_type dx = std::abs(static_cast<weight_type>(v % side) - static_cast<weight_type>(target % side));
+        weight_type dy = std::abs(static_cast<weight_type>(v / side) - static_cast<weight_type>(target / side));
+        return dx + dy;
+    }
+};
+
+struct no_heuristic {
+    weight_type operator()(std::uint32_t) const { return 0; }
+};
+
+grid_distance make_heuristic(const graph_type &graph) {
+    /// <summary>
+    /// Returns the A* heuristic of a road graph, searching from the first
+    /// corner of the grid to the opposite one.
+    /// </summary>
+    std::uint32_t vertices = graph.get_vertex_count();
+    return grid_distance{ grid_side(vertices), vertices - 1 };
+}
+
+
+void dijkstra_fibonacci(benchmark::State &state) {
+    /// <summary>
+    /// Shortest paths from vertex 0 with fhDijkstra.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    for (auto _ : state) {
+        fhShortestPaths<weight_type> paths = fhDijkstra(graph, 0);
+        benchmark::DoNotOptimize(paths.distance.data());
+    }
+    set_counters(state, graph);
+}
+
+void dijkstra_binary(benchmark::State &state) {
+    /// <summary>
+    /// Shortest paths from vertex 0 with a lazy deletion binary heap.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    for (auto _ : state) {
+        std::vector<weight_type> distance = lazy_shortest_paths(graph, 0, fhShortestPaths<weight_type>::no_vertex,
+                                                                no_heuristic());
+        benchmark::DoNotOptimize(distance.data());
+    }
+    set_counters(state, graph);
+}
+
+void prim_fibonacci(benchmark::State &state) {
+    /// <summary>
+    /// Minimum spanning forest with fhPrim.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    for (auto _ : state) {
+        fhSpanningForest<weight_type> forest = fhPrim(graph);
+        benchmark::DoNotOptimize(forest.weight);
+    }
+    set_counters(state, graph);
+}
+
+void prim_binary(benchmark::State &state) {
+    /// <summary>
+    /// Minimum spanning forest with a lazy deletion binary heap.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    for (auto _ : state) {
+        weight_type weight = lazy_prim(graph);
+        benchmark::DoNotOptimize(weight);
+    }
+    set_counters(state, graph);
+}
+
+void astar_fibonacci(benchmark::State &state) {
+    /// <summary>
+    /// Shortest path across a road graph with fhAstar.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    grid_distance heuristic = make_heuristic(graph);
+    for (auto _ : state) {
+        fhShortestPaths<weight_type> paths = fhAstar(graph, 0, heuristic.target, heuristic);
+        benchmark::DoNotOptimize(paths.distance.data());
+    }
+    set_counters(state, graph);
+}
+
+void astar_binary(benchmark::State &state) {
+    /// <summary>
+    /// Shortest path across a road graph with a lazy deletion binary heap.
+    /// </summary>
+    const graph_type &graph = get_graph(state);
+    grid_distance heuristic = make_heuristic(graph);
+    for (auto _ : state) {
+        std::vector<weight_type> distance = lazy_shortest_paths(graph, 0, heuristic.target, heuristic);
+        benchmark::DoNotOptimize(distance.data());
+    }
+    set_counters(state, graph);
+}
+}
+
+BENCHMARK(dijkstra_fibonacci)->Apply(sizes);
+BENCHMARK(dijkstra_binary)->Apply(sizes);
+
+BENCHMARK(prim_fibonacci)->Apply(sizes);
+BENCHMARK(prim_binary)->Apply(sizes);
+
+BENCHMARK(astar_fibonacci)->Apply(road_sizes);
+BENCHMARK(astar_binary)->Apply(road_sizes);
@@ -0,0 +1,212 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: fhStats
+    File: fhStats.h
+
+    Counters a FibonacciHeap keeps about the work its operations do,
+    read with get_stats(). They are only kept when FH_ENABLE_STATS is
+    defined before FibonacciHeap.h is included, otherwise every
+    recording call is empty and compiles away, and get_stats() returns
+    zeroes.
+*/
+#pragma once
+#include <cstdint>
+
+#ifdef FH_ENABLE_STATS
+#include <chrono>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FH_STATS_RDTSC 1
+#include <x86intrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define FH_STATS_RDTSC 1
+#include <intrin.h>
+#endif
+#endif
+
+struct fhStats {
+/// <summary>
+/// Plain counters of the work done by a FibonacciHeap, every field is
+/// a running total or maximum since the heap was constructed or its
+/// statistics were last reset.
+/// </summary>
+    // True if the counters are kept, FH_ENABLE_STATS was defined.
+#ifdef FH_ENABLE_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // Operations that are counted and timed. Operations made of other
+    // operations are only counted once, an erase is not also counted
+    // as a delete_min.
+    enum operation {
+        op_insert,
+        op_insert_bulk,
+        op_delete_min,
+        op_extract_k,
+        op_change_priority,
+        op_decrease_keys,
+        op_erase,
+        op_merge,
+        op_extract_while,
+        op_erase_if,
+        operation_count
+    };
+
+    // Histograms bucket values by their bit width, bucket 0 counts
+    // zeroes and bucket b counts values in [2^(b-1), 2^b).
+    static constexpr unsigned histogram_size = 65;
+
+    // Number of calls, processor cycles (steady clock ticks where
+    // there is no cycle counter) spent in them, and the most spent in
+    // any single call.
+    std::uint64_t operations[operation_count] = {};
+    std::uint64_t cycles[operation_count] = {};
+    std::uint64_t max_cycles[operation_count] = {};
+
+    // Number of consolidations, roots walked by them, and the longest
+    // root list any of them walked.
+    std::uint64_t consolidations = 0;
+    std::uint64_t roots_consolidated = 0;
+    std::uint64_t max_root_list = 0;
+    std::uint64_t root_list_histogram[histogram_size] = {};
+
+    // Trees linked by consolidations, and the most any single one
+    // linked.
+    std::uint64_t links = 0;
+    std::uint64_t max_links = 0;
+    std::uint64_t links_histogram[histogram_size] = {};
+
+    // Marked nodes cut by cascading cuts, and the longest chain of
+    // them cut at once.
+    std::uint64_t cascading_cuts = 0;
+    std::uint64_t max_cut_depth = 0;
+    std::uint64_t cut_depth_histogram[histogram_size] = {};
+
+    // Highest degree any root reached.
+    std::uint64_t max_degree = 0;
+
+    static unsigned bucket(std::uint64_t value) {
+        /// <summary>
+        /// Returns the histogram bucket of a value, its bit width.
+        /// </summary>
+        unsigned width = 0;
+        while (value) {
+            value >>= 1;
+            ++width;
+        }
+        return width;
+    }
+};
+
+
+class fhStatsRecorder {
+/// <summary>
+/// Base class of FibonacciHeap that records its statistics, empty when
+/// FH_ENABLE_STATS is not defined.
+/// </summary>
+#ifdef FH_ENABLE_STATS
+private:
+    fhStats stats;
+
+    // Number of timers running, only the outermost one records.
+    unsigned timing = 0;
+
+    static std::uint64_t cycles() {
+#ifdef FH_STATS_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+public:
+    class timer {
+    /// <summary>
+    /// Counts and times an operation from construction to destruction.
+    /// </summary>
+    private:
+        fhStatsRecorder &recorder;
+        fhStats::operation op;
+        std::uint64_t start = 0;
+
+    public:
+        timer(fhStatsRecorder &recorder, fhStats::operation op) : recorder(recorder), op(op) {
+            if (recorder.timing++ == 0) { start = cycles(); }
+        }
+
+        timer(const timer&) = delete;
+        timer& operator=(const timer&) = delete;
+
+        ~timer() {
+            if (--recorder.timing != 0) { return; }
+
+            std::uint64_t spent = cycles() - start;
+            fhStats &stats = recorder.stats;
+            ++stats.operations[op];
+            stats.cycles[op] += spent;
+            if (spent > stats.max_cycles[op]) { stats.max_cycles[op] = spent; }
+        }
+    };
+
+    fhStats get_stats() const { return stats; }
+
+    void reset_stats() { stats = fhStats(); }
+
+protected:
+    void record_consolidation(std::uint64_t roots, std::uint64_t links, std::uint64_t degree) {
+        /// <summary>
+        /// Record a consolidation, the roots it walked, the trees it
+        /// linked and the highest degree of the roots left.
+        /// </summary>
+        ++stats.consolidations;
+        stats.roots_consolidated += roots;
+        if (roots > stats.max_root_list) { stats.max_root_list = roots; }
+        ++stats.root_list_histogram[fhStats::bucket(roots)];
+
+        stats.links += links;
+        if (links > stats.max_links) { stats.max_links = links; }
+        ++stats.links_histogram[fhStats::bucket(links)];
+
+        if (degree > stats.max_degree) { stats.max_degree = degree; }
+    }
+
+    void record_cascade(std::uint64_t depth) {
+        /// <summary>
+        /// Record a cascading cut, the number of marked nodes it cut.
+        /// </summary>
+        stats.cascading_cuts += depth;
+        if (depth > stats.max_cut_depth) { stats.max_cut_depth = depth; }
+        ++stats.cut_depth_histogram[fhStats::bucket(depth)];
+    }
+#else
+public:
+    class timer {
+    public:
+        timer(fhStatsRecorder &, fhStats::operation) {}
+    };
+
+    fhStats get_stats() const { return fhStats(); }
+
+    void reset_stats() {}
+
+protected:
+    void record_consolidation(std::uint64_t, std::uint64_t, std::uint64_t) {}
+
+    void record_cascade(std::uint64_t) {}
+#endif
+};
@@ -0,0 +1,89 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: AllocatorTest
+    File: AllocatorTest.cpp
+
+    Tests for the slab pool and custom allocators: Nodes freed by an
+    extract are reused, and heaps with unequal stateful allocators are
+    merged and copied.
+*/
+#include <cstdio>
+#include <string>
+#include <utility>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+template <typename T>
+struct tagged_allocator {
+    typedef T value_type;
+    int id;
+    tagged_allocator(int id = 0) : id(id) {}
+    template <typename U> tagged_allocator(const tagged_allocator<U> &other) : id(other.id) {}
+    T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    void deallocate(T *p, std::size_t) { ::operator delete(p); }
+    template <typename U> bool operator==(const tagged_allocator<U> &other) const { return id == other.id; }
+    template <typename U> bool operator!=(const tagged_allocator<U> &other) const { return id != other.id; }
+};
+
+typedef FibonacciHeap<std::string, long long, std::less<long long>, tagged_allocator<std::string>> tagged;
+
+int main() {
+    tagged a(tagged_allocator<std::string>(1)), b(tagged_allocator<std::string>(2));
+    FH_CHECK(a.get_allocator().id == 1 && b.get_allocator().id == 2);
+    for (int i = 0; i < 100; ++i) {
+        a.insert(std::string(40, 'a' + i % 26), i * 2);
+        b.insert(std::string(40, 'b'), i * 2 + 1);
+    }
+    a.delete_min();
+    b.delete_min();
+
+    // Unequal allocators, so the Nodes of b are copied into a.
+    a += b;
+    FH_CHECK(b.is_empty() && a.get_size() == 198);
+    check_heap(a);
+
+    long long last = -1;
+    while (!a.is_empty()) {
+        auto m = a.extract_min();
+        FH_CHECK(m.second > last);
+        last = m.second;
+        // Reinserting reuses the Nodes freed by the extracts.
+        if (last % 7 == 0) { a.insert("x", 1000 + last); }
+    }
+
+    b.insert("q", 3);
+    tagged c(b);
+    c = b;
+    FH_CHECK(c.get_size() == 1 && c.find_min()->priority == 3);
+
+    // Nodes are released with the heap, and reused for a new batch.
+    FibonacciHeap<int> pool;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1000; ++i) { pool.insert(i, 1000 - i); }
+        for (int i = 0; i < 1000; ++i) { FH_CHECK(pool.extract_min().first == 999 - i); }
+    }
+
+    // Extracting from the empty heap throws and leaves it usable.
+    FH_CHECK(pool.is_empty() && extract_throws(pool));
+    int value = 0;
+    FH_CHECK(!pool.extract_min(value));
+    pool.insert(5, 5);
+    FH_CHECK(pool.extract_min().first == 5 && extract_throws(pool));
+
+    std::puts("AllocatorTest passed");
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: BulkInsertTest
+    File: BulkInsertTest.cpp
+
+    Tests for insert_bulk and the range constructor, from random access
+    and forward iterators, into empty and non-empty heaps.
+*/
+#include <cstdio>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+int main() {
+    std::mt19937 rng(5);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::pair<int, long long>> items;
+        int n = rng() % 3000;
+        for (int i = 0; i < n; ++i) { items.push_back({i, static_cast<long long>(rng() % 1000)}); }
+
+        heap h(items.begin(), items.end());
+        for (int i = 0; i < 50; ++i) { h.insert(-1, rng() % 1000); }
+        std::list<std::pair<int, long long>> more(items.begin(), items.begin() + n / 2);
+        h.insert_bulk(more.begin(), more.end());
+        check_heap(h);
+        FH_CHECK(h.get_size() == items.size() + more.size() + 50);
+
+        long long last = -1;
+        std::size_t count = 0;
+        while (!h.is_empty()) {
+            long long p = h.extract_min().second;
+            FH_CHECK(p >= last);
+            last = p;
+            ++count;
+            if (count % 500 == 0) { check_heap(h); }
+        }
+        FH_CHECK(count == items.size() + more.size() + 50);
+    }
+
+    heap empty;
+    std::vector<std::pair<int, long long>> none;
+    empty.insert_bulk(none.begin(), none.end());
+    FH_CHECK(empty.is_empty() && !empty.find_min());
+
+    std::puts("BulkInsertTest passed");
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: CheckpointTest
+    File: CheckpointTest.cpp
+
+    Tests for CompactFibonacciHeap checkpoints: heaps saved and loaded
+    from streams and memory, empty heaps, and damaged checkpoints that
+    must be rejected without changing the heap.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "CompactFibonacciHeap.h"
+#include "fhTest.h"
+
+static int make_int(int i) { return i; }
+
+// Too large to be kept in the Nodes, so checkpoints write its block.
+struct record {
+    int id;
+    double weight;
+    bool operator==(const record &other) const { return id == other.id && weight == other.weight; }
+};
+
+static record make_record(int i) { return record{i, i * 0.5}; }
+
+template <typename T>
+static void check_round_trip(T (*make)(int)) {
+    typedef CompactFibonacciHeap<T, long long> heap;
+    heap h;
+    std::vector<typename heap::handle> handles;
+    for (int i = 0; i < 3000; ++i) { handles.push_back(h.insert(make(i), (i * 7919) % 3000)); }
+    // The minimum is the first value, which is also erased below.
+    h.delete_min();
+    for (int i = 3; i < 3000; i += 3) { h.erase(handles[i]); }
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    h.save(stream);
+    std::string bytes = stream.str();
+    FH_CHECK(bytes.size() == h.get_checkpoint_size());
+
+    heap from_stream, from_memory;
+    from_stream.insert(make(-1), -1);
+    from_stream.load(stream);
+    from_memory.load(bytes.data(), bytes.size());
+    for (int i = 0; i < 3000; ++i) {
+        if (i % 3) {
+            FH_CHECK(from_stream.get_value(handles[i]) == make(i));
+            FH_CHECK(from_memory.get_priority(handles[i]) == h.get_priority(handles[i]));
+        }
+    }
+    while (!h.is_empty()) {
+        auto a = h.extract_min(), b = from_stream.extract_min(), c = from_memory.extract_min();
+        FH_CHECK(a.second == b.second && b.second == c.second);
+    }
+    FH_CHECK(from_stream.is_empty() && from_memory.is_empty());
+}
+
+static void test_checkpoints() {
+    check_round_trip<int>(make_int);
+    check_round_trip<record>(make_record);
+
+    static_assert(!fhInlineValue<record>::value, "");
+
+    // Empty heaps save and load without copying any Nodes.
+    CompactFibonacciHeap<int, long long> empty, loaded;
+    std::stringstream stream;
+    empty.save(stream);
+    std::string bytes = stream.str();
+    loaded.insert(1, 1);
+    loaded.load(bytes.data(), bytes.size());
+    FH_CHECK(loaded.is_empty());
+    loaded.insert(1, 1);
+    loaded.load(stream);
+    FH_CHECK(loaded.is_empty());
+}
+
+// Layout of a CompactFibonacciHeap<int, long long> Node in a checkpoint.
+struct raw_node {
+    std::uint32_t left, right, child, parent;
+    long long priority;
+    std::uint8_t degree;
+    unsigned char marked, used;
+    int value;
+};
+
+static bool rejects(const std::string &bytes) {
+    CompactFibonacciHeap<int, long long> h;
+    h.insert(5, 5);
+    try {
+        h.load(bytes.data(), bytes.size());
+    }
+    catch (const std::runtime_error &) {
+        FH_CHECK(h.get_size() == 1 && h.get_value(h.find_min()) == 5);
+        return true;
+    }
+    return false;
+}
+
+static void test_corrupt_checkpoints() {
+    static_assert(sizeof(raw_node) == 32, "");
+    CompactFibonacciHeap<int, long long> h;
+    std::vector<fhCompactHandle<int>> handles;
+    for (int i = 0; i < 500; ++i) { handles.push_back(h.insert(i, (i * 37) % 500)); }
+    h.delete_min();
+    for (int i = 7; i < 500; i += 7) { h.erase(handles[i]); }
+
+    std::stringstream stream;
+    h.save(stream);
+    const std::string good = stream.str();
+    FH_CHECK(!rejects(good));
+
+    const std::size_t count = (good.size() - sizeof(fhCheckpointHeader)) / sizeof(raw_node);
+    auto node_at = [](std::string &bytes, std::size_t index) {
+        return reinterpret_cast<raw_node*>(&bytes[sizeof(fhCheckpointHeader) + index * sizeof(raw_node)]);
+    };
+    auto header_of = [](std::string &bytes) {
+        fhCheckpointHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return header;
+    };
+    auto set_header = [](std::string &bytes, const fhCheckpointHeader &header) {
+        std::memcpy(&bytes[0], &header, sizeof(header));
+    };
+
+    // Used and freed nodes are written field by field, leaving the
+    // padding and everything but a freed node's next link as 0.
+    for (std::size_t i = 0; i < count; ++i) {
+        const char *bytes = &good[sizeof(fhCheckpointHeader) + i * sizeof(raw_node)];
+        FH_CHECK(bytes[offsetof(raw_node, used) + 1] == 0);
+        if (reinterpret_cast<const raw_node*>(bytes)->used) { continue; }
+        for (std::size_t b = sizeof(std::uint32_t); b < sizeof(raw_node); ++b) { FH_CHECK(bytes[b] == 0); }
+    }
+
+    std::string copy = good;
+    std::size_t live = 0, child = 0;
+    while (!node_at(copy, live)->used) { ++live; }
+    while (!node_at(copy, child)->used || node_at(copy, child)->parent == ~std::uint32_t(0)) { ++child; }
+
+    // A root with two children or more, and a child of it with none.
+    std::size_t parent = 0;
+    while (!node_at(copy, parent)->used || node_at(copy, parent)->parent != ~std::uint32_t(0) ||
+           node_at(copy, parent)->degree < 2) {
+        ++parent;
+    }
+    std::uint32_t leaf = node_at(copy, parent)->child;
+    while (node_at(copy, leaf)->degree) { leaf = node_at(copy, leaf)->right; }
+
+    // Take the leaf out of its ring, leaving its links to itself.
+    auto cut_leaf = [&](std::string &b) {
+        raw_node *l = node_at(b, leaf);
+        node_at(b, l->left)->right = l->right;
+        node_at(b, l->right)->left = l->left;
+        if (node_at(b, parent)->child == leaf) { node_at(b, parent)->child = l->right; }
+        l->left = l->right = leaf;
+    };
+
+    std::vector<std::function<void(std::string&)>> damage = {
+        [&](std::string &b) { for (std::size_t i = 0; i < count; ++i) { node_at(b, i)->right = 0x7777; } },
+        [&](std::string &b) { node_at(b, live)->left = static_cast<std::uint32_t>(count); },
+        [&](std::string &b) { node_at(b, live)->child = static_cast<std::uint32_t>(count + 1); },
+        [&](std::string &b) { node_at(b, live)->parent = static_cast<std::uint32_t>(count + 5); },
+        [&](std::string &b) { node_at(b, live)->degree = 48; },
+        [&](std::string &b) { node_at(b, live)->degree = node_at(b, live)->degree + 1; },
+        [&](std::string &b) { node_at(b, live)->used = 2; },
+        [&](std::string &b) { node_at(b, live)->marked = 7; },
+        [&](std::string &b) { node_at(b, 0)->used = 1; },
+        [&](std::string &b) { auto hd = header_of(b); hd.min_index = static_cast<std::uint32_t>(child); set_header(b, hd); },
+        [&](std::string &b) { auto hd = header_of(b); hd.min_index = static_cast<std::uint32_t>(count); set_header(b, hd); },
+        [&](std::string &b) { auto hd = header_of(b); hd.size += 1; set_header(b, hd); },
+        [&](std::string &b) { auto hd = header_of(b); node_at(b, hd.free_head)->left = hd.free_head; },
+        [&](std::string &b) { auto hd = header_of(b); hd.free_head = static_cast<std::uint32_t>(live); set_header(b, hd); },
+        // Rings missing a node, or reaching no root.
+        [&](std::string &b) { cut_leaf(b); },
+        [&](std::string &b) {
+            cut_leaf(b);
+            node_at(b, parent)->degree -= 1;
+            raw_node *l = node_at(b, leaf);
+            l->parent = l->child = leaf;
+            l->degree = 1;
+        },
+        // A ring running into another ring instead of closing.
+        [&](std::string &b) { node_at(b, leaf)->right = static_cast<std::uint32_t>(parent); },
+        // Out of heap order.
+        [&](std::string &b) { node_at(b, leaf)->priority = node_at(b, parent)->priority - 1; },
+        [&](std::string &b) { auto hd = header_of(b); node_at(b, parent)->priority = node_at(b, hd.min_index)->priority - 1; },
+        [&](std::string &b) { b.resize(b.size() - 1); },
+        [&](std::string &b) { b.resize(sizeof(fhCheckpointHeader) - 1); },
+    };
+    for (auto &apply : damage) {
+        std::string bytes = good;
+        apply(bytes);
+        FH_CHECK(rejects(bytes));
+    }
+
+    // A heap of another value type is not a checkpoint of this one.
+    CompactFibonacciHeap<record, long long> other;
+    bool threw = false;
+    try { other.load(good.data(), good.size()); }
+    catch (const std::runtime_error &) { threw = true; }
+    FH_CHECK(threw && other.is_empty());
+}
+
+int main() {
+    test_checkpoints();
+    test_corrupt_checkpoints();
+    std::puts("CheckpointTest passed");
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ClearTest
+    File: ClearTest.cpp
+
+    Tests for clear(): deep forests built by cascading cuts are torn
+    down without recursion, and the heap is usable afterwards.
+*/
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+int main() {
+    FibonacciHeap<std::string> h;
+    for (int round = 0; round < 5; ++round) {
+        std::vector<FibonacciHeap<std::string>::handle> handles;
+        for (int i = 0; i < 20000; ++i) { handles.push_back(h.insert(std::string(30, 'x'), i)); }
+        h.delete_min();
+        for (int i = 19999; i > 100; i -= 3) { h.decrease_key(handles[i], -i); }
+        h.delete_min();
+        check_heap(h);
+
+        h.clear();
+        FH_CHECK(h.is_empty() && !h.find_min());
+        h.clear();
+        h.insert("a", 1);
+        FH_CHECK(h.get_size() == 1 && h.find_min()->priority == 1);
+    }
+
+    std::puts("ClearTest passed");
+    return 0;
+}
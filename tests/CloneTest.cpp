@@ -0,0 +1,55 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: CloneTest
+    File: CloneTest.cpp
+
+    Tests for clone(): the copy has the same forest shape as the heap,
+    shares no Nodes with it, and extracts the same sequence.
+*/
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+int main() {
+    std::mt19937 rng(9);
+    for (int round = 0; round < 20; ++round) {
+        heap h;
+        std::vector<heap::handle> handles;
+        for (int i = 0; i < 2000; ++i) { handles.push_back(h.insert(i, rng() % 5000)); }
+        h.delete_min();
+        for (int i = 0; i < 300; ++i) { h.decrease_key(handles[1 + rng() % 1999], -static_cast<long long>(rng() % 100)); }
+        h.delete_min();
+
+        heap copy = h.clone();
+        check_heap(copy);
+        auto roots = h.get_roots(), copy_roots = copy.get_roots();
+        FH_CHECK(roots.size() == copy_roots.size());
+        for (std::size_t i = 0; i < roots.size(); ++i) {
+            FH_CHECK(roots[i] != copy_roots[i]);
+            FH_CHECK(roots[i]->priority == copy_roots[i]->priority && roots[i]->degree == copy_roots[i]->degree);
+        }
+        while (!h.is_empty()) { FH_CHECK(h.extract_min() == copy.extract_min()); }
+        FH_CHECK(copy.is_empty());
+    }
+
+    std::puts("CloneTest passed");
+    return 0;
+}
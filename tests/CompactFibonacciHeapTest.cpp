@@ -0,0 +1,119 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: CompactFibonacciHeapTest
+    File: CompactFibonacciHeapTest.cpp
+
+    Tests for CompactFibonacciHeap: random operations through 32-bit
+    handles checked against a std::multiset model, with copies and
+    moves of the heap in between.
+*/
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include "CompactFibonacciHeap.h"
+#include "fhTest.h"
+
+template <typename T>
+static void random_operations(T (*make)(int), unsigned seed) {
+    typedef CompactFibonacciHeap<T, long long> heap;
+    std::mt19937 rng(seed);
+    heap h;
+    std::multiset<std::pair<long long, int>> ref;
+    std::map<int, typename heap::handle> handles;
+    int next = 0;
+
+    if (seed % 2) { h.reserve(500); }
+    for (int step = 0; step < 3000; ++step) {
+        int op = rng() % 10;
+        if (op < 4) {
+            long long p = rng() % 500;
+            handles[next] = h.insert(make(next), p);
+            ref.insert({p, next++});
+        }
+        else if (op < 6 && !ref.empty()) {
+            auto id = ref.begin()->second;
+            auto m = h.extract_min();
+            FH_CHECK(m.second == ref.begin()->first);
+            // Ties may come out in any order, find the value's own entry.
+            for (auto it = ref.lower_bound({m.second, 0}); ; ++it) {
+                if (make(it->second) == m.first) { id = it->second; ref.erase(it); break; }
+            }
+            handles.erase(id);
+        }
+        else if (op < 8 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            long long old_p = h.get_priority(it->second);
+            long long new_p = static_cast<long long>(rng() % 500) - 100;
+            h.change_priority(it->second, new_p);
+            FH_CHECK(h.get_priority(it->second) == new_p && h.get_value(it->second) == make(it->first));
+            ref.erase(ref.find({old_p, it->first}));
+            ref.insert({new_p, it->first});
+        }
+        else if (op == 8 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            ref.erase(ref.find({h.get_priority(it->second), it->first}));
+            h.erase(it->second);
+            handles.erase(it);
+        }
+        else if (op == 9 && step % 100 == 0) {
+            heap copy(h), moved;
+            for (auto &e : handles) { FH_CHECK(copy.get_value(e.second) == h.get_value(e.second)); }
+            moved = std::move(copy);
+            FH_CHECK(moved.get_size() == h.get_size());
+            h = moved;
+        }
+
+        FH_CHECK(h.get_size() == ref.size());
+        if (!ref.empty()) { FH_CHECK(h.get_priority(h.find_min()) == ref.begin()->first); }
+        else { FH_CHECK(h.is_empty() && !h.find_min()); }
+    }
+}
+
+static int make_int(int i) { return i; }
+static std::string make_string(int i) { return std::string(30, 's') + std::to_string(i); }
+
+static void test_operations() {
+    static_assert(sizeof(fhCompactHandle<int>) == 4, "");
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        random_operations<int>(make_int, seed);
+        random_operations<std::string>(make_string, seed);
+    }
+
+    CompactFibonacciHeap<std::unique_ptr<int>> unique;
+    unique.insert(std::make_unique<int>(3), 1);
+    std::unique_ptr<int> out;
+    FH_CHECK(unique.extract_min(out) && *out == 3);
+}
+
+static void test_empty() {
+    CompactFibonacciHeap<int> h;
+    FH_CHECK(extract_throws(h));
+    h.insert(1, 1);
+    FH_CHECK(h.extract_min().first == 1 && extract_throws(h) && h.is_empty());
+}
+
+int main() {
+    test_operations();
+    test_empty();
+    std::puts("CompactFibonacciHeapTest passed");
+    return 0;
+}
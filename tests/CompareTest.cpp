@@ -0,0 +1,58 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: CompareTest
+    File: CompareTest.cpp
+
+    Tests for the Key and Compare parameters: a max heap, pairs of
+    keys ordered lexicographically, and a function pointer comparator.
+*/
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+static bool less_than(const long long &a, const long long &b) { return a < b; }
+
+int main() {
+    FibonacciHeap<int, double, std::greater<double>> max_heap;
+    for (int i = 0; i < 100; ++i) { max_heap.insert(i, i * 0.5); }
+    max_heap.delete_min();
+    check_heap(max_heap);
+    for (int i = 98; i >= 0; --i) { FH_CHECK(max_heap.extract_min().first == i); }
+
+    typedef std::pair<long long, unsigned> ranked;
+    FibonacciHeap<int, ranked> pairs;
+    pairs.insert(1, ranked(5, 2));
+    pairs.insert(2, ranked(5, 1));
+    pairs.insert(3, ranked(4, 9));
+    FH_CHECK(pairs.extract_min().first == 3);
+    FH_CHECK(pairs.extract_min().first == 2);
+    pairs.change_priority(1, ranked(5, 2), ranked(1, 1));
+    FH_CHECK(pairs.find_min()->priority == ranked(1, 1));
+
+    typedef FibonacciHeap<int, long long, bool(*)(const long long&, const long long&)> pointer_heap;
+    pointer_heap fp(less_than);
+    fp.insert(1, 3);
+    fp.insert(2, 1);
+    pointer_heap copy(fp);
+    copy = fp;
+    FH_CHECK(fp.extract_min().first == 2 && copy.extract_min().first == 2);
+
+    std::puts("CompareTest passed");
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ConcurrentFibonacciHeapTest
+    File: ConcurrentFibonacciHeapTest.cpp
+
+    Tests for ConcurrentFibonacciHeap: every value inserted by the
+    producers is extracted exactly once, a single thread sees exact
+    order, and clear() racing inserts never reuses freed memory.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentFibonacciHeap.h"
+#include "fhTest.h"
+
+static void test_concurrent_producers() {
+    const int producers = 4, count = 5000;
+    ConcurrentFibonacciHeap<std::string> h;
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&h, &done, p] {
+            for (int i = 0; i < count; ++i) { h.insert(std::to_string(i), static_cast<long long>(i * producers + p)); }
+            ++done;
+        });
+    }
+
+    std::vector<long long> got;
+    std::string value;
+    long long priority;
+    while (done < producers || !h.is_empty()) {
+        if (h.extract_min(value, priority)) { got.push_back(priority); }
+    }
+    for (auto &t : threads) { t.join(); }
+    while (h.extract_min(value, priority)) { got.push_back(priority); }
+
+    FH_CHECK(static_cast<int>(got.size()) == producers * count);
+    std::sort(got.begin(), got.end());
+    for (int i = 0; i < producers * count; ++i) { FH_CHECK(got[i] == i); }
+}
+
+static void test_concurrent_order() {
+    ConcurrentFibonacciHeap<int> h;
+    for (int i = 1000; i > 0; --i) { h.insert(i, i); }
+    int value;
+    long long priority, last = 0;
+    while (h.extract_min(value, priority)) {
+        FH_CHECK(priority > last && value == priority);
+        last = priority;
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1000; ++i) { h.insert(i, i); }
+        for (int i = 0; i < 1000; ++i) { FH_CHECK(h.extract_min(value)); }
+    }
+    FH_CHECK(h.is_empty());
+}
+
+static void test_concurrent_clear() {
+    for (int round = 0; round < 30; ++round) {
+        ConcurrentFibonacciHeap<int, long long> h;
+        int value;
+        long long priority;
+        for (int i = 0; i < 200; ++i) { h.insert(i, i); }
+        for (int i = 0; i < 100; ++i) { FH_CHECK(h.extract_min(value)); }
+
+        // The extract melds the buffer, which is lent the free Nodes of
+        // the main heap, then clear() drops the main heap's memory.
+        for (int i = 0; i < 10; ++i) { h.insert(i, i); }
+        FH_CHECK(h.extract_min(value));
+        h.clear();
+        for (int i = 0; i < 300; ++i) { h.insert(i, -i); }
+        FH_CHECK(h.get_size() == 300);
+        FH_CHECK(h.extract_min(value, priority) && priority == -299);
+
+        std::thread producer([&h] { for (int i = 0; i < 1000; ++i) { h.insert(i, i); } });
+        for (int i = 0; i < 50; ++i) { h.clear(); }
+        producer.join();
+        h.clear();
+        FH_CHECK(h.is_empty() && !h.extract_min(value));
+    }
+}
+
+int main() {
+    test_concurrent_producers();
+    test_concurrent_order();
+    test_concurrent_clear();
+    std::puts("ConcurrentFibonacciHeapTest passed");
+    return 0;
+}
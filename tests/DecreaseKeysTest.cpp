@@ -0,0 +1,91 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: DecreaseKeysTest
+    File: DecreaseKeysTest.cpp
+
+    Tests for decrease_keys: batches of handles lowered with one cut
+    phase, including handles repeated in a batch and priorities that
+    do not go down, checked against a std::multiset model.
+*/
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+int main() {
+    std::mt19937 rng(13);
+    for (int round = 0; round < 20; ++round) {
+        heap h;
+        std::multiset<std::pair<long long, int>> ref;
+        std::map<int, heap::handle> handles;
+        int next = 0;
+
+        for (int step = 0; step < 1000; ++step) {
+            int op = rng() % 4;
+            if (op < 2 || handles.empty()) {
+                long long p = rng() % 1000;
+                handles[next] = h.insert(next, p);
+                ref.insert({p, next++});
+            }
+            else if (op == 2) {
+                auto m = h.extract_min();
+                FH_CHECK(m.second == ref.begin()->first);
+                FH_CHECK(ref.erase({m.second, m.first}) == 1);
+                handles.erase(m.first);
+            }
+            else {
+                std::vector<std::pair<heap::handle, long long>> batch;
+                int count = rng() % 30;
+                for (int i = 0; i < count; ++i) {
+                    auto it = std::next(handles.begin(), rng() % handles.size());
+                    long long old_p = h.get_priority(it->second);
+                    for (auto &b : batch) {
+                        if (b.first == it->second) { old_p = b.second; }
+                    }
+                    // Now and then a priority that does not go down.
+                    long long new_p = rng() % 4 ? old_p - static_cast<long long>(rng() % 300) : old_p + static_cast<long long>(rng() % 50);
+                    batch.push_back({it->second, new_p});
+                }
+                h.decrease_keys(batch.begin(), batch.end());
+                // The last entry for a handle wins.
+                std::map<int, long long> last;
+                for (auto &b : batch) { last[h.get_value(b.first)] = b.second; }
+                for (auto &l : last) {
+                    for (auto it = ref.begin(); it != ref.end(); ++it) {
+                        if (it->second == l.first) { ref.erase(it); break; }
+                    }
+                    ref.insert({l.second, l.first});
+                    FH_CHECK(h.get_priority(handles[l.first]) == l.second);
+                }
+            }
+
+            check_heap(h);
+            FH_CHECK(h.get_size() == ref.size());
+            if (!ref.empty()) { FH_CHECK(h.find_min()->priority == ref.begin()->first); }
+        }
+    }
+
+    std::puts("DecreaseKeysTest passed");
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ExtractKTest
+    File: ExtractKTest.cpp
+
+    Tests for extract_k: the k smallest Nodes come out in order, k
+    larger than the heap takes everything, and the forest left behind
+    is consolidated.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+int main() {
+    std::mt19937 rng(11);
+    for (int round = 0; round < 20; ++round) {
+        heap h;
+        std::multiset<std::pair<long long, int>> ref;
+        int next = 0;
+        for (int step = 0; step < 1000; ++step) {
+            if (rng() % 3) {
+                long long p = rng() % 500;
+                h.insert(next, p);
+                ref.insert({p, next++});
+                continue;
+            }
+
+            std::vector<std::pair<int, long long>> out;
+            std::size_t k = rng() % 20;
+            h.extract_k(k, std::back_inserter(out));
+            FH_CHECK(out.size() == std::min(k, ref.size()));
+            for (auto &e : out) {
+                FH_CHECK(e.second == ref.begin()->first);
+                FH_CHECK(ref.erase({e.second, e.first}) == 1);
+            }
+            check_heap(h);
+            FH_CHECK(h.get_size() == ref.size());
+        }
+
+        std::vector<std::pair<int, long long>> rest;
+        h.extract_k(ref.size() + 10, std::back_inserter(rest));
+        FH_CHECK(rest.size() == ref.size() && h.is_empty());
+        FH_CHECK(std::is_sorted(rest.begin(), rest.end(), [](const std::pair<int, long long> &a, const std::pair<int, long long> &b) { return a.second < b.second; }));
+    }
+
+    std::puts("ExtractKTest passed");
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: GraphAlgorithmsTest
+    File: GraphAlgorithmsTest.cpp
+
+    Tests for GraphAlgorithms: fhDijkstra and fhAstar against a binary
+    heap Dijkstra, including inconsistent admissible heuristics, and
+    fhPrim against Kruskal on random graphs.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "GraphAlgorithms.h"
+#include "fhTest.h"
+
+typedef fhCsrGraph<long long> graph;
+
+static std::vector<long long> reference_distances(const graph &g, unsigned source) {
+    std::vector<long long> distance(g.get_vertex_count(), fhShortestPaths<long long>::unreached);
+    std::priority_queue<std::pair<long long, unsigned>, std::vector<std::pair<long long, unsigned>>, std::greater<>> queue;
+    distance[source] = 0;
+    queue.push({0, source});
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        if (d > distance[v]) { continue; }
+        for (unsigned i = g.offsets[v]; i < g.offsets[v + 1]; ++i) {
+            if (d + g.weights[i] < distance[g.targets[i]]) {
+                distance[g.targets[i]] = d + g.weights[i];
+                queue.push({distance[g.targets[i]], g.targets[i]});
+            }
+        }
+    }
+    return distance;
+}
+
+static unsigned find_root(std::vector<unsigned> &parent, unsigned x) {
+    while (parent[x] != x) { x = parent[x] = parent[parent[x]]; }
+    return x;
+}
+
+int main() {
+    for (unsigned seed = 0; seed < 60; ++seed) {
+        std::mt19937 rng(seed);
+        unsigned n = 1 + rng() % 300, m = rng() % (n * 6 + 1);
+        std::vector<graph::edge> edges;
+        for (unsigned i = 0; i < m; ++i) {
+            edges.push_back({unsigned(rng() % n), unsigned(rng() % n), static_cast<long long>(rng() % (seed % 3 ? 1000 : 3))});
+        }
+        graph g(n, edges);
+        FH_CHECK(g.get_edge_count() == m);
+
+        unsigned source = rng() % n, target = rng() % n;
+        auto paths = fhDijkstra(g, source);
+        auto expect = reference_distances(g, source);
+        FH_CHECK(paths.distance == expect);
+        for (unsigned v = 0; v < n; ++v) {
+            if (v == source || expect[v] == paths.unreached) { continue; }
+            unsigned u = paths.parent[v];
+            bool found = false;
+            for (unsigned i = g.offsets[u]; i < g.offsets[u + 1]; ++i) {
+                found |= g.targets[i] == v && paths.distance[u] + g.weights[i] == paths.distance[v];
+            }
+            FH_CHECK(found);
+        }
+
+        FH_CHECK(fhAstar(g, source, target, [](unsigned) { return 0LL; }).distance[target] == expect[target]);
+        std::vector<graph::edge> reversed;
+        for (auto &e : edges) { reversed.push_back({e.to, e.from, e.weight}); }
+        auto to_target = reference_distances(graph(n, reversed), target);
+        std::vector<long long> guess(n);
+        for (unsigned v = 0; v < n; ++v) {
+            guess[v] = to_target[v] == paths.unreached ? 0 : static_cast<long long>(rng() % (to_target[v] + 1));
+        }
+        FH_CHECK(fhAstar(g, source, target, [&guess](unsigned v) { return guess[v]; }).distance[target] == expect[target]);
+
+        graph undirected(n, edges, true);
+        auto forest = fhPrim(undirected);
+        std::vector<unsigned> parent(n);
+        std::iota(parent.begin(), parent.end(), 0);
+        auto sorted = edges;
+        std::sort(sorted.begin(), sorted.end(), [](const graph::edge &a, const graph::edge &b) { return a.weight < b.weight; });
+        long long total = 0;
+        unsigned trees = n;
+        for (auto &e : sorted) {
+            unsigned x = find_root(parent, e.from), y = find_root(parent, e.to);
+            if (x != y) {
+                parent[x] = y;
+                total += e.weight;
+                --trees;
+            }
+        }
+        FH_CHECK(forest.weight == total);
+        unsigned roots = 0;
+        for (unsigned v = 0; v < n; ++v) { roots += forest.parent[v] == forest.no_vertex; }
+        FH_CHECK(roots == trees);
+    }
+
+    fhCsrGraph<double> empty;
+    FH_CHECK(empty.get_vertex_count() == 0 && fhDijkstra(empty, 0).distance.empty());
+
+    std::puts("GraphAlgorithmsTest passed");
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: HandleTest
+    File: HandleTest.cpp
+
+    Tests for the handles insert returns: random inserts, extracts,
+    decrease_key, increase_key and erase checked against a
+    std::multiset model, with the circular lists of every tree checked
+    after each one.
+*/
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+static void random_operations(unsigned seed) {
+    std::mt19937 rng(seed);
+    heap h;
+    std::multiset<std::pair<long long, int>> ref;
+    std::map<int, heap::handle> handles;
+    int next = 0;
+
+    for (int step = 0; step < 3000; ++step) {
+        int op = rng() % 10;
+        if (op < 4) {
+            long long p = rng() % 500;
+            handles[next] = h.insert(next, p);
+            ref.insert({p, next++});
+        }
+        else if (op < 6 && !ref.empty()) {
+            auto m = h.extract_min();
+            FH_CHECK(m.second == ref.begin()->first);
+            FH_CHECK(ref.erase({m.second, m.first}) == 1);
+            handles.erase(m.first);
+        }
+        else if (op < 9 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            long long old_p = h.get_priority(it->second);
+            long long new_p = static_cast<long long>(rng() % 500) - 100;
+            if (new_p < old_p) { h.decrease_key(it->second, new_p); }
+            else { h.increase_key(it->second, new_p); }
+            FH_CHECK(h.get_priority(it->second) == new_p && h.get_value(it->second) == it->first);
+            ref.erase(ref.find({old_p, it->first}));
+            ref.insert({new_p, it->first});
+        }
+        else if (op == 9 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            ref.erase(ref.find({h.get_priority(it->second), it->first}));
+            h.erase(it->second);
+            handles.erase(it);
+        }
+
+        check_heap(h);
+        FH_CHECK(h.get_size() == ref.size());
+        if (!ref.empty()) { FH_CHECK(h.find_min()->priority == ref.begin()->first); }
+    }
+
+    while (!ref.empty()) {
+        FH_CHECK(h.extract_min().second == ref.begin()->first);
+        ref.erase(ref.begin());
+    }
+    FH_CHECK(h.is_empty() && !h.find_min());
+}
+
+int main() {
+    for (unsigned seed = 0; seed < 8; ++seed) { random_operations(seed); }
+    std::puts("HandleTest passed");
+    return 0;
+}
@@ -0,0 +1,185 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: IncrementalConsolidationTest
+    File: IncrementalConsolidationTest.cpp
+
+    Tests for the incremental consolidation mode: random operations
+    under consolidation budgets of 1 to 6 roots, checked against a
+    std::multiset model, with the budget changed and heaps of other
+    budgets merged in along the way, and the comparisons every
+    operation makes after a bulk build or a merge.
+*/
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+static void random_operations(unsigned seed) {
+    std::mt19937 rng(seed);
+    heap h;
+    std::multiset<std::pair<long long, int>> ref;
+    std::map<int, heap::handle> handles;
+    int next = 0;
+
+    h.set_consolidation_budget(1 + seed % 6);
+    FH_CHECK(h.get_consolidation_budget() == 1 + seed % 6);
+    for (int step = 0; step < 2000; ++step) {
+        int op = rng() % 14;
+        if (op < 5) {
+            long long p = rng() % 500;
+            handles[next] = h.insert(next, p);
+            ref.insert({p, next++});
+        }
+        else if (op < 8 && !ref.empty()) {
+            auto m = h.extract_min();
+            FH_CHECK(m.second == ref.begin()->first);
+            FH_CHECK(ref.erase({m.second, m.first}) == 1);
+            handles.erase(m.first);
+        }
+        else if (op < 10 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            long long old_p = h.get_priority(it->second);
+            long long new_p = static_cast<long long>(rng() % 500) - 100;
+            h.change_priority(it->second, new_p);
+            ref.erase(ref.find({old_p, it->first}));
+            ref.insert({new_p, it->first});
+        }
+        else if (op == 10 && !handles.empty()) {
+            auto it = std::next(handles.begin(), rng() % handles.size());
+            ref.erase(ref.find({h.get_priority(it->second), it->first}));
+            h.erase(it->second);
+            handles.erase(it);
+        }
+        else if (op == 11) {
+            heap other;
+            if (rng() % 2) { other.set_consolidation_budget(2); }
+            int count = rng() % 20;
+            for (int i = 0; i < count; ++i) {
+                long long p = rng() % 500;
+                handles[next] = other.insert(next, p);
+                ref.insert({p, next++});
+            }
+            h.merge(std::move(other));
+        }
+        else if (op == 12) {
+            std::vector<std::pair<int, long long>> items;
+            int count = rng() % 30;
+            for (int i = 0; i < count; ++i) {
+                long long p = rng() % 500;
+                items.push_back({next, p});
+                ref.insert({p, next++});
+            }
+            h.insert_bulk(items.begin(), items.end());
+        }
+        else if (op == 13) {
+            // A budget of 0 goes back to full consolidation.
+            h.set_consolidation_budget(rng() % 4);
+        }
+
+        check_heap(h);
+        FH_CHECK(h.get_size() == ref.size());
+        if (!ref.empty()) { FH_CHECK(h.find_min()->priority == ref.begin()->first); }
+    }
+
+    while (!ref.empty()) {
+        FH_CHECK(h.extract_min().second == ref.begin()->first);
+        ref.erase(ref.begin());
+    }
+}
+
+// Ordering of the priorities that counts how often it is called.
+struct counting_less {
+    static std::size_t calls;
+    bool operator()(long long a, long long b) const {
+        ++calls;
+        return a < b;
+    }
+};
+
+std::size_t counting_less::calls = 0;
+
+typedef FibonacciHeap<int, long long, counting_less> counted_heap;
+
+static std::size_t comparisons_of(std::size_t &before) {
+    std::size_t spent = counting_less::calls - before;
+    before = counting_less::calls;
+    return spent;
+}
+
+static void test_work_per_operation() {
+    // Every step links budget roots plus the ones the operation added,
+    // each at most a degree's worth of times, and the minimum is found
+    // among the ranked roots.
+    const std::size_t n = 100000, budget = 16, per_operation = 2000;
+    std::mt19937 rng(17);
+    std::vector<std::pair<int, long long>> items;
+    for (std::size_t i = 0; i < n; ++i) { items.push_back({static_cast<int>(i), static_cast<long long>(rng() >> 1)}); }
+
+    counted_heap h;
+    h.set_consolidation_budget(budget);
+    std::size_t before = counting_less::calls;
+    h.insert_bulk(items.begin(), items.end());
+    FH_CHECK(comparisons_of(before) <= 3 * n);
+
+    std::vector<counted_heap::handle> handles;
+    for (int step = 0; step < 2000; ++step) {
+        h.delete_min();
+        FH_CHECK(comparisons_of(before) <= per_operation);
+        handles.push_back(h.insert(step, static_cast<long long>(rng() >> 1)));
+        FH_CHECK(comparisons_of(before) <= per_operation);
+    }
+    for (std::size_t i = 0; i < handles.size(); i += 2) {
+        h.decrease_key(handles[i], -static_cast<long long>(i));
+        FH_CHECK(comparisons_of(before) <= per_operation);
+    }
+
+    // A merged heap that never consolidated is linked by the merge.
+    counted_heap other;
+    for (std::size_t i = 0; i < n / 2; ++i) { other.insert(-1, static_cast<long long>(rng() >> 1)); }
+    comparisons_of(before);
+    h.merge(std::move(other));
+    FH_CHECK(comparisons_of(before) <= 3 * n);
+    for (int step = 0; step < 2000; ++step) {
+        h.delete_min();
+        FH_CHECK(comparisons_of(before) <= per_operation);
+    }
+    check_heap(h);
+
+    // The roots present when the budget is set are linked right away.
+    counted_heap late(items.begin(), items.end());
+    late.set_consolidation_budget(budget);
+    comparisons_of(before);
+    for (int step = 0; step < 100; ++step) {
+        late.delete_min();
+        FH_CHECK(comparisons_of(before) <= per_operation);
+    }
+}
+
+int main() {
+    for (unsigned seed = 0; seed < 12; ++seed) { random_operations(seed); }
+    test_work_per_operation();
+    std::puts("IncrementalConsolidationTest passed");
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: IndexedFibonacciHeapTest
+    File: IndexedFibonacciHeapTest.cpp
+
+    Tests for IndexedFibonacciHeap: random operations by value checked
+    against a std::map model, merges of overlapping heaps, and heaps
+    using a stateful allocator.
+*/
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "IndexedFibonacciHeap.h"
+#include "fhTest.h"
+
+typedef IndexedFibonacciHeap<int> heap;
+
+// The minimum node can be read, but not changed behind the index.
+static_assert(std::is_same<decltype(std::declval<const heap&>().find_min()), const fhNode<int, long long>*>::value,
+              "find_min returns a const node");
+
+template <typename T>
+struct tagged_allocator {
+    typedef T value_type;
+    int id;
+    tagged_allocator(int id = 0) : id(id) {}
+    template <typename U> tagged_allocator(const tagged_allocator<U> &other) : id(other.id) {}
+    T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    void deallocate(T *p, std::size_t) { ::operator delete(p); }
+    template <typename U> bool operator==(const tagged_allocator<U> &other) const { return id == other.id; }
+    template <typename U> bool operator!=(const tagged_allocator<U> &other) const { return id != other.id; }
+};
+
+static void test_operations() {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 20; ++round) {
+        heap h;
+        std::map<int, long long> ref;
+
+        for (int step = 0; step < 1000; ++step) {
+            int op = rng() % 10;
+            int value = rng() % 300;
+            long long p = rng() % 1000;
+            if (op < 4) {
+                auto inserted = h.insert(value, p);
+                FH_CHECK(inserted.second == !ref.count(value));
+                if (inserted.second) { ref[value] = p; }
+                FH_CHECK(h.get_value(inserted.first) == value);
+            }
+            else if (op < 6) {
+                bool changed = h.change_priority(value, p);
+                FH_CHECK(changed == (ref.count(value) > 0));
+                if (changed) { ref[value] = p; }
+            }
+            else if (op < 7) {
+                FH_CHECK(h.erase(value) == (ref.erase(value) > 0));
+            }
+            else if (op < 8 && !ref.empty()) {
+                auto m = h.extract_min();
+                FH_CHECK(ref.count(m.first) && ref[m.first] == m.second);
+                ref.erase(m.first);
+            }
+            else if (op < 9) {
+                heap other;
+                std::map<int, long long> other_ref;
+                int count = rng() % 30;
+                for (int i = 0; i < count; ++i) {
+                    int v = rng() % 300;
+                    long long q = rng() % 1000;
+                    if (other.insert(v, q).second) { other_ref[v] = q; }
+                }
+                h.merge(std::move(other));
+                FH_CHECK(other.is_empty());
+                // A value in both heaps keeps the lower priority.
+                for (auto &e : other_ref) {
+                    auto it = ref.find(e.first);
+                    if (it == ref.end()) { ref.insert(e); }
+                    else { it->second = std::min(it->second, e.second); }
+                }
+            }
+            else {
+                FH_CHECK(h.contains(value) == (ref.count(value) > 0));
+            }
+
+            FH_CHECK(h.get_size() == ref.size());
+            if (!ref.empty()) {
+                long long lowest = LLONG_MAX;
+                for (auto &e : ref) { lowest = std::min(lowest, e.second); }
+                FH_CHECK(h.find_min()->priority == lowest);
+            }
+        }
+
+        for (auto &e : ref) {
+            auto node = h.find(e.first);
+            FH_CHECK(node && h.get_priority(node) == e.second);
+        }
+        heap moved(std::move(h));
+        moved.clear();
+        FH_CHECK(moved.is_empty() && !moved.contains(0));
+    }
+
+    IndexedFibonacciHeap<std::string> strings;
+    strings.insert("a", 3);
+    strings.insert(std::string("b"), 1);
+    FH_CHECK(strings.change_priority("a", 0));
+    FH_CHECK(strings.extract_min().first == "a");
+}
+
+static void test_allocator() {
+    typedef IndexedFibonacciHeap<int, long long, std::less<long long>, tagged_allocator<int>> tagged;
+    tagged a(std::less<long long>(), tagged_allocator<int>(1)), b(std::less<long long>(), tagged_allocator<int>(2));
+    for (int i = 0; i < 100; ++i) {
+        a.insert(i, i);
+        b.insert(i + 50, i);
+    }
+    a.merge(std::move(b));
+    FH_CHECK(b.is_empty() && a.get_size() == 150);
+    FH_CHECK(a.get_priority(a.find(60)) == 10 && a.get_priority(a.find(120)) == 70);
+    long long last = -1;
+    while (!a.is_empty()) {
+        long long p = a.extract_min().second;
+        FH_CHECK(p >= last);
+        last = p;
+    }
+}
+
+static void test_empty() {
+    heap h;
+    FH_CHECK(extract_throws(h));
+    h.insert(1, 1);
+    FH_CHECK(h.extract_min().first == 1 && extract_throws(h) && !h.contains(1));
+}
+
+int main() {
+    test_operations();
+    test_empty();
+    test_allocator();
+    std::puts("IndexedFibonacciHeapTest passed");
+    return 0;
+}
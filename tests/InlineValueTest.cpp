@@ -0,0 +1,174 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: InlineValueTest
+    File: InlineValueTest.cpp
+
+    Tests for values kept inline in the Nodes: FibonacciHeap and
+    CompactFibonacciHeap with inline and out of line values against a
+    std::multimap model, values built from references into the heap,
+    and constructors that throw.
+*/
+#include <cstdio>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "CompactFibonacciHeap.h"
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+struct small_pair {
+    short a, b;
+    bool operator==(const small_pair &other) const { return a == other.a && b == other.b; }
+};
+
+static int make_int(int x) { return x; }
+static double make_double(int x) { return x * 0.5; }
+static small_pair make_pair(int x) { return small_pair{short(x), short(x >> 3)}; }
+static std::string make_string(int x) { return std::string(30, 'a') + std::to_string(x); }
+
+template <typename Heap, typename V>
+static void erase_value(std::multimap<long long, V> &ref, const std::pair<V, long long> &m) {
+    auto range = ref.equal_range(m.second);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == m.first) {
+            ref.erase(it);
+            return;
+        }
+    }
+    FH_CHECK(false);
+}
+
+template <typename Heap, typename V>
+static void random_operations(V (*make)(int)) {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 5; ++round) {
+        Heap h;
+        std::multimap<long long, V> ref;
+        for (int step = 0; step < 3000; ++step) {
+            int op = rng() % 10;
+            if (op < 5 || h.is_empty()) {
+                long long p = rng() % 1000;
+                V value = make(rng() % 100000);
+                h.insert(value, p);
+                ref.emplace(p, value);
+            }
+            else if (op < 8) {
+                auto m = h.extract_min();
+                FH_CHECK(m.second == ref.begin()->first);
+                erase_value<Heap>(ref, m);
+            }
+            else if (op == 8) {
+                Heap copy(h), assigned;
+                FH_CHECK(copy.get_size() == h.get_size());
+                assigned = copy;
+                copy.clear();
+                std::swap(h, assigned);
+            }
+            else if (rng() % 50 == 0) {
+                h.clear();
+                ref.clear();
+            }
+        }
+        while (!h.is_empty()) {
+            auto m = h.extract_min();
+            FH_CHECK(m.second == ref.begin()->first);
+            erase_value<Heap>(ref, m);
+        }
+        FH_CHECK(ref.empty());
+    }
+}
+
+static void test_inline_values() {
+    static_assert(fhInlineValue<int>::value && fhInlineValue<small_pair>::value, "");
+    static_assert(!fhInlineValue<std::string>::value, "");
+    random_operations<FibonacciHeap<int, long long>>(make_int);
+    random_operations<FibonacciHeap<double, long long>>(make_double);
+    random_operations<FibonacciHeap<small_pair, long long>>(make_pair);
+    random_operations<FibonacciHeap<std::string, long long>>(make_string);
+    random_operations<CompactFibonacciHeap<int, long long>>(make_int);
+    random_operations<CompactFibonacciHeap<double, long long>>(make_double);
+    random_operations<CompactFibonacciHeap<small_pair, long long>>(make_pair);
+    random_operations<CompactFibonacciHeap<std::string, long long>>(make_string);
+
+    // Inline values are kept across erases, and in checkpoints.
+    CompactFibonacciHeap<int, long long> h;
+    std::vector<fhCompactHandle<int>> handles;
+    for (int i = 0; i < 5000; ++i) { handles.push_back(h.insert(i * 3, (i * 7919) % 5000)); }
+    for (int i = 0; i < 5000; i += 3) { h.erase(handles[i]); }
+    std::stringstream stream;
+    h.save(stream);
+    FH_CHECK(stream.str().size() == h.get_checkpoint_size());
+    CompactFibonacciHeap<int, long long> loaded;
+    loaded.load(stream);
+    for (int i = 1; i < 5000; ++i) {
+        if (i % 3) { FH_CHECK(loaded.get_value(handles[i]) == i * 3); }
+    }
+    while (!h.is_empty()) { FH_CHECK(h.extract_min() == loaded.extract_min()); }
+}
+
+struct fragile {
+    int value;
+    explicit fragile(int value) : value(value) {
+        if (value < 0) { throw std::runtime_error("fragile"); }
+    }
+};
+
+static void test_allocate() {
+    // Values built from a value already in the heap, across growth.
+    CompactFibonacciHeap<int, long long> ints;
+    auto first_int = ints.insert(7, 0);
+    for (int i = 1; i < 5000; ++i) { ints.insert(ints.get_value(first_int), i); }
+    for (int i = 0; i < 5000; ++i) { FH_CHECK(ints.extract_min().first == 7); }
+
+    CompactFibonacciHeap<std::string, long long> strings;
+    auto first_string = strings.insert(std::string(100, 'x'), 0);
+    for (int i = 1; i < 5000; ++i) { strings.insert(strings.get_value(first_string), i); }
+    for (int i = 0; i < 5000; ++i) { FH_CHECK(strings.extract_min().first.size() == 100); }
+
+    // A throwing constructor leaves the heap as it was.
+    CompactFibonacciHeap<fragile, long long> h;
+    std::size_t expect = 0;
+    for (int i = 0; i < 3000; ++i) {
+        try {
+            h.emplace(i, i % 3 ? i : -1);
+            ++expect;
+        }
+        catch (const std::runtime_error &) {}
+        if (i % 500 == 0 && !h.is_empty()) { h.delete_min(); --expect; }
+    }
+    FH_CHECK(h.get_size() == expect);
+    std::stringstream stream;
+    h.save(stream);
+    CompactFibonacciHeap<fragile, long long> loaded;
+    loaded.load(stream);
+    long long last = -1;
+    while (!loaded.is_empty()) {
+        auto m = loaded.extract_min();
+        FH_CHECK(m.second > last && m.first.value == m.second);
+        last = m.second;
+    }
+}
+
+int main() {
+    test_inline_values();
+    test_allocate();
+    std::puts("InlineValueTest passed");
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: MergeTest
+    File: MergeTest.cpp
+
+    Tests for merge, the + and += operators, and move construction and
+    assignment, including handles that stay valid across a merge.
+*/
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<std::unique_ptr<int>> unique_heap;
+
+int main() {
+    unique_heap a, b;
+    a.emplace(3, new int(3));
+    auto moved = b.emplace(5, new int(5));
+    b.emplace(1, new int(1));
+    a.merge(std::move(b));
+    FH_CHECK(b.is_empty() && a.get_size() == 3 && a.find_min()->priority == 1);
+    a.decrease_key(moved, 0);
+    FH_CHECK(*a.extract_min().first == 5);
+
+    unique_heap c(std::move(a));
+    FH_CHECK(a.is_empty() && c.get_size() == 2);
+    unique_heap d;
+    d = std::move(c);
+    d.merge(unique_heap());
+    FH_CHECK(d.get_size() == 2);
+
+    FibonacciHeap<int> x, y;
+    x.insert(1, 4);
+    y.insert(2, 2);
+    FibonacciHeap<int> z = x + y;
+    FH_CHECK(x.get_size() == 1 && y.get_size() == 1 && z.get_size() == 2 && z.find_min()->priority == 2);
+    FibonacciHeap<int> w = std::move(x) + std::move(y);
+    FH_CHECK(w.get_size() == 2);
+    FibonacciHeap<int> e;
+    e += w;
+    FH_CHECK(w.is_empty() && e.get_size() == 2);
+    e.swap(w);
+    FH_CHECK(e.is_empty() && w.get_size() == 2);
+
+    // Many small shards melded into one heap.
+    std::mt19937 rng(2);
+    std::multiset<long long> ref;
+    FibonacciHeap<int> big;
+    for (int round = 0; round < 300; ++round) {
+        FibonacciHeap<int> shard;
+        int n = rng() % 50;
+        for (int i = 0; i < n; ++i) {
+            long long p = rng() % 1000;
+            shard.insert(i, p);
+            ref.insert(p);
+        }
+        big.merge(std::move(shard));
+        if (rng() % 3 == 0 && !ref.empty()) {
+            FH_CHECK(big.extract_min().second == *ref.begin());
+            ref.erase(ref.begin());
+            check_heap(big);
+        }
+    }
+    for (long long p : ref) { FH_CHECK(big.extract_min().second == p); }
+    FH_CHECK(big.is_empty());
+
+    std::puts("MergeTest passed");
+    return 0;
+}
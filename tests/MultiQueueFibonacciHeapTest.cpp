@@ -0,0 +1,111 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: MultiQueueFibonacciHeapTest
+    File: MultiQueueFibonacciHeapTest.cpp
+
+    Tests for MultiQueueFibonacciHeap: every value inserted by the
+    producers is extracted exactly once, and a single queue extracts
+    in exact order.
+*/
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MultiQueueFibonacciHeap.h"
+#include "fhTest.h"
+
+// Comparator and allocator without default constructors, which every
+// heap is constructed from.
+struct by_distance {
+    long long target;
+    explicit by_distance(long long target) : target(target) {}
+    long long distance(long long p) const { return p > target ? p - target : target - p; }
+    bool operator()(long long a, long long b) const { return distance(a) < distance(b); }
+};
+
+template <typename T>
+struct arena_allocator {
+    typedef T value_type;
+    int *allocations;
+    explicit arena_allocator(int *allocations) : allocations(allocations) {}
+    template <typename U> arena_allocator(const arena_allocator<U> &other) : allocations(other.allocations) {}
+    T* allocate(std::size_t n) {
+        ++*allocations;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T *p, std::size_t) { ::operator delete(p); }
+    template <typename U> bool operator==(const arena_allocator<U> &other) const { return allocations == other.allocations; }
+    template <typename U> bool operator!=(const arena_allocator<U> &other) const { return allocations != other.allocations; }
+};
+
+static void test_stateful_parameters() {
+    int allocations = 0;
+    MultiQueueFibonacciHeap<int, long long, by_distance, arena_allocator<int>> h(1, 1, by_distance(50),
+                                                                              arena_allocator<int>(&allocations));
+    for (int i = 0; i <= 100; i += 10) { h.insert(i, i); }
+    FH_CHECK(allocations > 0);
+
+    int value;
+    long long priority;
+    FH_CHECK(h.extract_min(value, priority) && priority == 50);
+    FH_CHECK(h.extract_min(value, priority) && (priority == 40 || priority == 60));
+}
+
+int main() {
+    test_stateful_parameters();
+
+    const int producers = 4, count = 5000;
+    MultiQueueFibonacciHeap<std::string> h(4, 2);
+    FH_CHECK(h.get_queue_count() == 8);
+
+    std::atomic<long long> total{0};
+    std::atomic<int> extracted{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::string value;
+            long long priority;
+            for (int i = 0; i < count; ++i) {
+                h.insert(std::to_string(i), static_cast<long long>(i * producers + p));
+                if (i % 2 && h.extract_min(value, priority)) { total += priority; ++extracted; }
+            }
+        });
+    }
+    for (auto &t : threads) { t.join(); }
+
+    std::string value;
+    long long priority;
+    while (h.extract_min(value, priority)) { total += priority; ++extracted; }
+    long long n = producers * count;
+    FH_CHECK(extracted == n && total == n * (n - 1) / 2);
+
+    MultiQueueFibonacciHeap<int> one(1, 1);
+    for (int i = 100; i > 0; --i) { one.insert(i, i); }
+    int x;
+    long long last = 0;
+    while (one.extract_min(x, priority)) {
+        FH_CHECK(priority > last);
+        last = priority;
+    }
+    one.insert(3, 3);
+    one.clear();
+    FH_CHECK(one.is_empty() && !one.extract_min(x));
+
+    std::puts("MultiQueueFibonacciHeapTest passed");
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ParallelConsolidationTest
+    File: ParallelConsolidationTest.cpp
+
+    Tests for parallel consolidation: heaps consolidating in parallel
+    above a root-count threshold extract the same sequence as a heap
+    that does not, with the default threads and a custom executor.
+*/
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+
+static void compare_with_serial(unsigned seed) {
+    std::mt19937 rng(seed);
+    heap serial, parallel;
+    parallel.set_parallel_consolidation(1 + rng() % 200, 1 + rng() % 6);
+    if (seed % 4 == 1) {
+        serial.set_consolidation_budget(3);
+        parallel.set_consolidation_budget(3);
+    }
+
+    std::vector<std::pair<int, long long>> items;
+    int n = rng() % 3000;
+    for (int i = 0; i < n; ++i) { items.push_back({i, static_cast<long long>(rng() % 1000)}); }
+    serial.insert_bulk(items.begin(), items.end());
+    parallel.insert_bulk(items.begin(), items.end());
+
+    for (int step = 0; step < 3000 && !serial.is_empty(); ++step) {
+        int op = rng() % 6;
+        if (op < 2) {
+            long long p = rng() % 1000;
+            serial.insert(step, p);
+            parallel.insert(step, p);
+        }
+        else if (op == 2 && rng() % 8 == 0) {
+            heap a, b;
+            int count = rng() % 300;
+            for (int i = 0; i < count; ++i) {
+                long long p = rng() % 1000;
+                a.insert(-i, p);
+                b.insert(-i, p);
+            }
+            serial.merge(std::move(a));
+            parallel.merge(std::move(b));
+        }
+        else { FH_CHECK(serial.extract_min().second == parallel.extract_min().second); }
+
+        if (step % 300 == 0) { check_heap(parallel); }
+    }
+    while (!serial.is_empty()) { FH_CHECK(serial.extract_min().second == parallel.extract_min().second); }
+    FH_CHECK(parallel.is_empty());
+}
+
+static void test_parallel_executor() {
+    int calls = 0;
+    heap::executor run = [&calls](std::size_t count, const std::function<void(std::size_t)> &job) {
+        ++calls;
+        for (std::size_t i = 0; i < count; ++i) { job(i); }
+    };
+
+    std::mt19937 rng(3);
+    std::vector<std::pair<int, long long>> items;
+    for (int i = 0; i < 5000; ++i) { items.push_back({i, static_cast<long long>(rng() % 100000)}); }
+    heap h, plain;
+    h.set_parallel_consolidation(100, 4, run);
+    h.insert_bulk(items.begin(), items.end());
+    plain.insert_bulk(items.begin(), items.end());
+    while (!plain.is_empty()) { FH_CHECK(h.extract_min().second == plain.extract_min().second); }
+    FH_CHECK(calls > 0 && h.is_empty());
+    heap copy(h);
+    FH_CHECK(copy.get_parallel_threshold() == h.get_parallel_threshold());
+}
+
+int main() {
+    for (unsigned seed = 0; seed < 20; ++seed) { compare_with_serial(seed); }
+    test_parallel_executor();
+    std::puts("ParallelConsolidationTest passed");
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: PrioritySchedulerTest
+    File: PrioritySchedulerTest.cpp
+
+    Tests for PriorityScheduler: every task submitted by many producers
+    runs once, a single worker runs tasks in priority order, and aging
+    keeps a stream of urgent tasks from starving an old one.
+*/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "PriorityScheduler.h"
+#include "fhTest.h"
+
+static void test_producers() {
+    std::atomic<long> sum{0};
+    PriorityScheduler<long long> scheduler(4, 1, 8);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 3; ++t) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < 5000; ++i) { scheduler.submit([&sum, i] { sum += i; }, (i * 7919) % 1000); }
+        });
+    }
+    for (auto &p : producers) { p.join(); }
+    scheduler.wait_idle();
+    FH_CHECK(scheduler.get_unfinished() == 0);
+    FH_CHECK(sum == 3L * 5000 * 4999 / 2);
+
+    // Tasks still queued when the scheduler is destroyed still run.
+    for (int i = 0; i < 1000; ++i) { scheduler.submit([&sum] { sum += 1; }, i); }
+}
+
+static void test_order() {
+    std::atomic<bool> go{false};
+    std::vector<int> order;
+    PriorityScheduler<long long> scheduler(1, 0, 1);
+    scheduler.submit([&go] { while (!go) { std::this_thread::yield(); } }, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 9; i >= 0; --i) { scheduler.submit([&order, i] { order.push_back(i); }, i); }
+    go = true;
+    scheduler.wait_idle();
+    FH_CHECK(order.size() == 10);
+    for (int i = 0; i < 10; ++i) { FH_CHECK(order[i] == i); }
+}
+
+static void test_aging() {
+    std::atomic<bool> go{false}, ran{false};
+    std::atomic<int> before{0};
+    PriorityScheduler<long long> scheduler(1, 10, 1);
+    scheduler.submit([&go] { while (!go) { std::this_thread::yield(); } }, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    scheduler.submit([&ran] { ran = true; }, 1000);
+
+    auto urgent = [&] { if (!ran) { ++before; } };
+    for (int i = 0; i < 3; ++i) { scheduler.submit(urgent, 0); }
+    go = true;
+    for (int submitted = 0; !ran && submitted < 100000; ++submitted) {
+        scheduler.submit(urgent, 0);
+        while (scheduler.get_unfinished() > 4) { std::this_thread::yield(); }
+    }
+    scheduler.wait_idle();
+    // 1000 / 10 dispatches is when the old task catches up.
+    FH_CHECK(ran && before < 1000);
+}
+
+int main() {
+    test_producers();
+    test_order();
+    test_aging();
+    std::puts("PrioritySchedulerTest passed");
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: PruneTest
+    File: PruneTest.cpp
+
+    Tests for extract_while, erase_if and shift_all_keys, checked
+    against a std::multiset model with the shifts applied eagerly.
+*/
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+typedef FibonacciHeap<int, long long> heap;
+typedef std::multiset<std::pair<long long, int>> model;
+
+static void test_pruning() {
+    std::mt19937 rng(42);
+    heap h;
+    model ref;
+    int next = 0;
+
+    for (int step = 0; step < 2000; ++step) {
+        int op = rng() % 8;
+        if (op < 4) {
+            long long p = static_cast<long long>(rng() % 2000) - 1000;
+            h.insert(next, p);
+            ref.insert({p, next++});
+        }
+        else if (op == 4) {
+            long long delta = static_cast<long long>(rng() % 500) - 250;
+            h.shift_all_keys(delta);
+            model shifted;
+            for (auto &e : ref) { shifted.insert({e.first + delta, e.second}); }
+            ref.swap(shifted);
+        }
+        else if (op == 5 && !ref.empty()) {
+            long long cut = ref.begin()->first + static_cast<long long>(rng() % 300);
+            std::vector<std::pair<int, long long>> out;
+            if (rng() & 1) { h.extract_while(cut, std::back_inserter(out)); }
+            else { h.extract_while([cut](long long p) { return p <= cut; }, std::back_inserter(out)); }
+            for (auto &e : out) {
+                FH_CHECK(e.second <= cut);
+                FH_CHECK(ref.erase({e.second, e.first}) == 1);
+            }
+            FH_CHECK(ref.empty() || ref.begin()->first > cut);
+        }
+        else if (op == 6) {
+            int mod = 2 + rng() % 7;
+            std::size_t erased = h.erase_if([mod](int v, long long) { return v % mod == 0; });
+            std::size_t expect = 0;
+            for (auto it = ref.begin(); it != ref.end();) {
+                if (it->second % mod == 0) { it = ref.erase(it); ++expect; }
+                else { ++it; }
+            }
+            FH_CHECK(erased == expect);
+        }
+        else if (op == 7 && !ref.empty()) {
+            auto m = h.extract_min();
+            FH_CHECK(m.second == ref.begin()->first);
+            FH_CHECK(ref.erase({m.second, m.first}) == 1);
+        }
+
+        check_heap(h);
+        FH_CHECK(h.get_size() == ref.size());
+    }
+
+    // Merging keeps the other heap's shifted priorities.
+    heap other;
+    other.shift_all_keys(100);
+    other.insert(-1, 5);
+    h.merge(std::move(other));
+    ref.insert({5, -1});
+    while (!ref.empty()) {
+        FH_CHECK(h.extract_min().second == ref.begin()->first);
+        ref.erase(ref.begin());
+    }
+}
+
+static void test_shift_visible() {
+    // Nodes handed out show the shifted priorities.
+    heap h;
+    heap::handle one = h.insert(1, 10);
+    h.insert(2, 20);
+    h.shift_all_keys(5);
+    FH_CHECK(h.find_min()->priority == 15 && h.get_priority(one) == 15);
+    FH_CHECK(h.find(2, 25) && !h.find(2, 20));
+    h.change_priority(one, 30);
+    FH_CHECK(h.find_min()->priority == 25);
+    check_heap(h);
+
+    // Priorities next to the limits are exact after a shift.
+    h.insert(3, LLONG_MIN);
+    FH_CHECK(h.extract_min().second == LLONG_MIN);
+    h.shift_all_keys(LLONG_MIN + 100);
+    FH_CHECK(h.find_min()->priority == LLONG_MIN + 125);
+
+    // Ordered by std::greater the largest priority stays on top.
+    FibonacciHeap<int, double, std::greater<double>> g;
+    g.insert(1, 1.5);
+    g.insert(2, -2.0);
+    g.shift_all_keys(-0.5);
+    FH_CHECK(g.find_min()->priority == 1.0);
+    FH_CHECK(g.extract_min().second == 1.0 && g.extract_min().second == -2.5);
+}
+
+static void test_shift_overflow() {
+    // A shift past the limits throws and changes no priority.
+    heap h;
+    h.insert(1, LLONG_MAX - 10);
+    h.insert(2, 0);
+    h.insert(3, LLONG_MIN + 10);
+    bool thrown = false;
+    try { h.shift_all_keys(11); }
+    catch (const std::overflow_error &) { thrown = true; }
+    FH_CHECK(thrown);
+    thrown = false;
+    try { h.shift_all_keys(-11); }
+    catch (const std::overflow_error &) { thrown = true; }
+    FH_CHECK(thrown);
+    FH_CHECK(h.find_min()->priority == LLONG_MIN + 10);
+
+    h.shift_all_keys(10);
+    FH_CHECK(h.extract_min().second == LLONG_MIN + 20);
+    FH_CHECK(h.extract_min().second == 10 && h.extract_min().second == LLONG_MAX);
+
+    // Unsigned priorities shift up to their maximum.
+    FibonacciHeap<int, unsigned> u;
+    u.insert(1, 4000000000u);
+    thrown = false;
+    try { u.shift_all_keys(300000000u); }
+    catch (const std::overflow_error &) { thrown = true; }
+    FH_CHECK(thrown && u.find_min()->priority == 4000000000u);
+    u.shift_all_keys(294967295u);
+    FH_CHECK(u.extract_min().second == 4294967295u);
+}
+
+int main() {
+    test_pruning();
+    test_shift_visible();
+    test_shift_overflow();
+    std::puts("PruneTest passed");
+    return 0;
+}
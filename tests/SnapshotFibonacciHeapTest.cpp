@@ -0,0 +1,69 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: SnapshotFibonacciHeapTest
+    File: SnapshotFibonacciHeapTest.cpp
+
+    Tests for SnapshotFibonacciHeap: snapshots share the heap until one
+    side changes it, and are never changed by the other side.
+*/
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SnapshotFibonacciHeap.h"
+#include "fhTest.h"
+
+typedef SnapshotFibonacciHeap<std::string> heap;
+
+int main() {
+    heap live;
+    std::vector<heap::handle> handles;
+    for (int i = 0; i < 100; ++i) { handles.push_back(live.insert(std::to_string(i), i + 10)); }
+    live.delete_min();
+
+    heap snap = live.snapshot();
+    FH_CHECK(live.is_shared() && snap.get_size() == 99 && snap.find_min() == live.find_min());
+
+    // The owner changing the heap leaves the snapshot with the old one.
+    live.decrease_key(handles[50], 1);
+    FH_CHECK(!live.is_shared());
+    FH_CHECK(live.find_min()->priority == 1 && snap.find_min()->priority == 11);
+
+    heap copy = snap, nested = snap.snapshot();
+    while (!copy.is_empty()) { copy.delete_min(); }
+    FH_CHECK(extract_throws(copy));
+    FH_CHECK(snap.get_size() == 99 && nested.get_size() == 99);
+    FH_CHECK(nested.extract_min().first == "1");
+    FH_CHECK(snap.find_min()->priority == 11);
+
+    live.erase(handles[99]);
+    FH_CHECK(live.get_size() == 98);
+    heap moved(std::move(live));
+    FH_CHECK(moved.get_size() == 98 && live.is_empty());
+    moved.decrease_key(handles[20], 0);
+    FH_CHECK(moved.extract_min().first == "20");
+
+    FibonacciHeap<std::string> base;
+    base.insert("x", 3);
+    heap wrapped(std::move(base));
+    heap kept = wrapped.snapshot();
+    wrapped.clear();
+    FH_CHECK(wrapped.is_empty() && kept.get_size() == 1);
+
+    std::puts("SnapshotFibonacciHeapTest passed");
+    return 0;
+}
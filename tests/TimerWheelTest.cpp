@@ -0,0 +1,147 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: TimerWheelTest
+    File: TimerWheelTest.cpp
+
+    Tests for TimerWheel: random schedules, cancels, reschedules and
+    advances checked against a std::map model, with every timer firing
+    once, in deadline order, no earlier than its deadline.
+*/
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TimerWheel.h"
+#include "fhTest.h"
+
+typedef TimerWheel<std::string> wheel;
+
+static void random_operations(unsigned resolution, unsigned seed) {
+    std::mt19937_64 rng(seed * 31 + resolution);
+    std::uint64_t now = rng() % (std::uint64_t(1) << 40);
+    wheel w(now, resolution);
+    std::map<int, std::pair<wheel::handle, std::uint64_t>> live;
+    int next = 0;
+
+    for (int step = 0; step < 2000; ++step) {
+        int op = rng() % 10;
+        if (op < 5) {
+            std::uint64_t span = std::uint64_t(1) << (rng() % 40);
+            // Some deadlines are already in the past.
+            std::uint64_t deadline = now + rng() % span - (rng() % 4 == 0 ? rng() % 8 : 0);
+            live[next] = {w.schedule(std::to_string(next), deadline), deadline};
+            ++next;
+        }
+        else if (op < 7 && !live.empty()) {
+            auto it = std::next(live.begin(), rng() % live.size());
+            if (rng() % 2) {
+                w.cancel(it->second.first);
+                live.erase(it);
+            }
+            else {
+                std::uint64_t deadline = now + rng() % (std::uint64_t(1) << (rng() % 30));
+                w.reschedule(it->second.first, deadline);
+                it->second.second = deadline;
+                FH_CHECK(w.get_deadline(it->second.first) == deadline);
+            }
+        }
+        else {
+            std::uint64_t jump = rng() % 3 == 0 ? rng() % (std::uint64_t(1) << (rng() % 34)) : rng() % 200;
+            std::vector<std::pair<std::string, std::uint64_t>> fired;
+            now += jump;
+            w.advance(now, std::back_inserter(fired));
+
+            std::uint64_t last = 0;
+            for (auto &f : fired) {
+                auto it = live.find(std::stoi(f.first));
+                FH_CHECK(it != live.end());
+                FH_CHECK(it->second.second == f.second && f.second <= now && f.second >= last);
+                last = f.second;
+                live.erase(it);
+            }
+            for (auto &l : live) { FH_CHECK(l.second.second > now); }
+        }
+        FH_CHECK(w.get_size() == live.size());
+    }
+
+    w.clear();
+    FH_CHECK(w.is_empty());
+}
+
+static void test_long_jumps() {
+    // One timer on each level and one beyond the wheel, every one
+    // reached by a single jump over the empty rotations before it.
+    const std::uint64_t deadlines[] = {70, 64 * 64 * 3 + 5, 64ull * 64 * 64 * 7 + 3, 64ull * 64 * 64 * 64 * 5 + 1};
+    for (unsigned resolution : {0u, 4u}) {
+        TimerWheel<int> w(1, resolution);
+        for (int i = 0; i < 4; ++i) { w.schedule(i, deadlines[i] << resolution); }
+
+        std::vector<std::pair<int, std::uint64_t>> out;
+        for (int i = 0; i < 4; ++i) {
+            std::uint64_t due = deadlines[i] << resolution;
+            w.advance(due - 1, std::back_inserter(out));
+            FH_CHECK(out.size() == static_cast<std::size_t>(i));
+            w.advance(due, std::back_inserter(out));
+            FH_CHECK(out.size() == static_cast<std::size_t>(i) + 1 && out.back().first == i);
+        }
+        FH_CHECK(w.is_empty());
+
+        // Idle jumps far past the wheel with timers left on its levels.
+        std::uint64_t now = w.get_time();
+        for (int i = 0; i < 1000; ++i) {
+            w.schedule(i, now + (std::uint64_t(1) << 23) + i);
+            now += std::uint64_t(1) << 22;
+            w.advance(now, std::back_inserter(out));
+        }
+        w.advance(now + (std::uint64_t(1) << 24), std::back_inserter(out));
+        FH_CHECK(out.size() == 1004 && w.is_empty());
+    }
+}
+
+static void test_null_handle() {
+    // A default constructed handle is ignored.
+    TimerWheel<int> w;
+    w.schedule(1, 10);
+    w.reschedule(TimerWheel<int>::handle(), 5);
+    w.cancel(TimerWheel<int>::handle());
+    std::vector<std::pair<int, std::uint64_t>> out;
+    w.advance(10, std::back_inserter(out));
+    FH_CHECK(out.size() == 1 && out[0].second == 10 && w.is_empty());
+}
+
+int main() {
+    test_long_jumps();
+    test_null_handle();
+    for (unsigned resolution : {0u, 3u, 10u}) {
+        for (unsigned seed = 0; seed < 5; ++seed) { random_operations(resolution, seed); }
+    }
+
+    TimerWheel<int> w;
+    std::vector<TimerWheel<int>::handle> handles;
+    for (int i = 0; i < 20000; ++i) { handles.push_back(w.schedule(i, 1000 + i % 5000)); }
+    for (int i = 0; i < 20000; i += 2) { w.cancel(handles[i]); }
+    std::vector<std::pair<int, std::uint64_t>> out;
+    w.advance(100000, std::back_inserter(out));
+    FH_CHECK(out.size() == 10000 && w.is_empty());
+
+    std::puts("TimerWheelTest passed");
+    return 0;
+}
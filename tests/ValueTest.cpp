@@ -0,0 +1,58 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: ValueTest
+    File: ValueTest.cpp
+
+    Tests for values constructed in place: move-only values through
+    insert(T&&), emplace and extract_min(T&).
+*/
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+struct task {
+    std::unique_ptr<int> buffer;
+    std::function<int()> run;
+    explicit task(int v) : buffer(new int(v)), run([v] { return v; }) {}
+};
+
+int main() {
+    FibonacciHeap<task> tasks;
+    tasks.emplace(5, 5);
+    tasks.insert(task(3), 3);
+    task moved(9);
+    tasks.insert(std::move(moved), 9);
+
+    auto first = tasks.extract_min();
+    FH_CHECK(*first.first.buffer == 3 && first.second == 3 && first.first.run() == 3);
+    task out(0);
+    FH_CHECK(tasks.extract_min(out) && *out.buffer == 5);
+    FH_CHECK(tasks.extract_min(out) && *out.buffer == 9);
+    FH_CHECK(!tasks.extract_min(out) && *out.buffer == 9);
+
+    FibonacciHeap<std::unique_ptr<int>> unique;
+    unique.emplace(1, new int(4));
+    unique.insert(std::make_unique<int>(2), 0);
+    FH_CHECK(*unique.extract_min().first == 2);
+    FH_CHECK(*unique.extract_min().first == 4);
+
+    std::puts("ValueTest passed");
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: fhStatsTest
+    File: fhStatsTest.cpp
+
+    Tests for the statistics FibonacciHeap records when FH_ENABLE_STATS
+    is defined, in a separate test since the define changes the heap.
+*/
+#define FH_ENABLE_STATS
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "FibonacciHeap.h"
+#include "fhTest.h"
+
+int main() {
+    FibonacciHeap<int> h;
+    std::mt19937 rng(1);
+    std::vector<FibonacciHeap<int>::handle> handles;
+    for (int i = 0; i < 10000; ++i) { handles.push_back(h.insert(i, rng() % 100000)); }
+    h.delete_min();
+    for (int i = 0; i < 5000; ++i) {
+        auto node = handles[1 + rng() % 9999];
+        h.decrease_key(node, h.get_priority(node) - 200000 - static_cast<long long>(rng() % 1000));
+    }
+    while (!h.is_empty()) { h.delete_min(); }
+
+    fhStats stats = h.get_stats();
+    FH_CHECK(stats.operations[fhStats::op_insert] == 10000);
+    FH_CHECK(stats.operations[fhStats::op_delete_min] == 10000);
+    FH_CHECK(stats.operations[fhStats::op_change_priority] > 0);
+    FH_CHECK(stats.links >= 9999 && stats.max_degree > 0 && stats.consolidations > 0);
+    FH_CHECK(stats.cascading_cuts > 0 && stats.max_cut_depth > 0);
+
+    h.reset_stats();
+    FH_CHECK(h.get_stats().consolidations == 0 && h.get_stats().operations[fhStats::op_insert] == 0);
+
+    std::puts("fhStatsTest passed");
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+    Copyright 2020 Tonia Sanzo ©
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+    Title: fhTest
+    File: fhTest.h
+
+    Checks shared by the tests in tests/. FH_CHECK stays on in Release
+    builds, unlike assert, and check_heap walks every tree of a
+    FibonacciHeap to compare its shape with the heap's size.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#define FH_CHECK(condition)                                                          \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                            \
+        }                                                                            \
+    } while (false)
+
+// Returns the number of Nodes in the tree rooted at node, checking the
+// parent links, the sibling links, the degrees and the heap order.
+template <typename Node, typename Compare>
+std::size_t check_tree(const Node *node, const Compare &less) {
+    std::size_t count = 1;
+    unsigned children = 0;
+
+    if (node->child) {
+        const Node *curr = node->child;
+        do {
+            FH_CHECK(curr->parent == node);
+            FH_CHECK(curr->right->left == curr);
+            FH_CHECK(!less(curr->priority, node->priority));
+            ++children;
+            count += check_tree(curr, less);
+            curr = curr->right;
+        } while (curr != node->child);
+    }
+
+    FH_CHECK(children == node->degree);
+    return count;
+}
+
+// Check every tree of heap, and that they hold get_size() Nodes.
+template <typename Heap>
+void check_heap(Heap &heap) {
+    std::size_t count = 0;
+    for (const auto *root : heap.get_roots()) {
+        FH_CHECK(!root->parent);
+        count += check_tree(root, heap.get_compare());
+    }
+    FH_CHECK(count == heap.get_size());
+}
+
+// Returns true if extract_min on the empty heap throws std::out_of_range.
+template <typename Heap>
+bool extract_throws(Heap &heap) {
+    try { heap.extract_min(); }
+    catch (const std::out_of_range &) { return true; }
+    return false;
+}